@@ -8,14 +8,15 @@
 
 #pragma once
 #include <assert.h>
-#include <libsais.h>
-#include <libsais64.h>
 
+#include <array>
 #include <cstdint>
-#include <gsaca-double-sort-par.hpp>
+#include <span>
 
-#include "lce/lce_naive_wordwise.hpp"
+#include "lce/suffix_comparison.hpp"
 #include "rmq/rmq_n.hpp"
+#include "rmq/rmq_offline.hpp"
+#include "suffix_sort/suffix_array_construction.hpp"
 
 #ifdef ALX_BENCHMARK_INTERNAL
 #include <fmt/core.h>
@@ -29,7 +30,12 @@
 
 namespace alx::lce {
 
-template <typename t_char_type = uint8_t, typename t_index_type = uint32_t>
+// The suffix array and the LCP array are built with t_construction, see
+// suffix_sort/suffix_array_construction.hpp. Range minima over the LCP array
+// are answered by t_rmq, e.g., rmq::rmq_succinct for less space.
+template <typename t_char_type = uint8_t, typename t_index_type = uint32_t,
+          typename t_construction = alx::suffix_sort::gsaca_backend,
+          typename t_rmq = alx::rmq::rmq_n<t_index_type, t_index_type>>
 class lce_classic {
  public:
   typedef t_char_type char_type;
@@ -38,67 +44,60 @@ class lce_classic {
   }
 
   lce_classic(char_type const* text, size_t size) : m_text(text), m_size(size) {
-    std::vector<t_index_type> sa(size);
     // sort sa
 #ifdef ALX_BENCHMARK_INTERNAL
     alx::util::timer t;
+    fmt::print(" sa_backend={} phi_lcp={}", t_construction::name,
+               t_construction::phi_lcp);
 #ifdef ALX_BENCHMARK_SPACE
     size_t mem_before = malloc_count_current();
     malloc_count_reset_peak();
 #endif
 #endif
-    gsaca_for_lce(text, sa.data(), size);
+    std::vector<t_index_type> sa =
+        alx::suffix_sort::suffix_array<t_index_type, t_construction>(text,
+                                                                     size);
 #ifdef ALX_BENCHMARK_INTERNAL
-    fmt::print(" gsaca_time={}", t.get_and_reset());
+    fmt::print(" sa_time={}", t.get_and_reset());
 #ifdef ALX_BENCHMARK_SPACE
-    fmt::print(" gsaca_mem={}", malloc_count_current() - mem_before);
-    fmt::print(" gsaca_mem_peak={}", malloc_count_peak() - mem_before);
+    fmt::print(" sa_mem={}", malloc_count_current() - mem_before);
+    fmt::print(" sa_mem_peak={}", malloc_count_peak() - mem_before);
+    mem_before = malloc_count_current();
+    malloc_count_reset_peak();
 #endif
 #endif
 
     // build isa
-    m_isa.resize(size);
-#pragma omp parallel for
-    for (size_t i = 0; i < sa.size(); ++i) {
-      m_isa[sa[i]] = i;
-    }
+    m_isa = alx::suffix_sort::inverse_suffix_array(sa);
+#ifdef ALX_BENCHMARK_INTERNAL
+    fmt::print(" isa_time={}", t.get_and_reset());
+#endif
 
     // build lcp
-    m_lcp.resize(sa.size());
-    m_lcp[0] = 0;
-    size_t current_lcp = 0;
-
-#pragma omp parallel
-    {
-      const int t = omp_get_thread_num();
-      const int nt = omp_get_num_threads();
-      const size_t slice_size = size / nt;
-
-      const size_t begin = t * slice_size;
-      const size_t end = (t < nt - 1) ? (t + 1) * slice_size : size;
-
-      size_t current_lcp = 0;
-      for (size_t i{begin}; i < end; ++i) {
-        size_t suffix_array_pos = m_isa[i];
-        if (suffix_array_pos == 0) {
-          continue;
-        }
-        assert(suffix_array_pos != 0);
-
-        size_t preceding_suffix_pos = sa[suffix_array_pos - 1];
-        current_lcp += lce_naive_wordwise<char_type>::lce_uneq(
-            text, size, i + current_lcp, preceding_suffix_pos + current_lcp);
-        m_lcp[suffix_array_pos] = current_lcp;
-        assert(lce_naive_wordwise<char_type>::lce_uneq(
-                   text, size, i, preceding_suffix_pos) == current_lcp);
+    m_lcp = alx::suffix_sort::lcp_array<t_construction>(text, size, sa, m_isa);
+#ifdef ALX_BENCHMARK_INTERNAL
+    fmt::print(" lcp_time={}", t.get_and_reset());
+#ifdef ALX_BENCHMARK_SPACE
+    fmt::print(" isa_lcp_mem_peak={}", malloc_count_peak() - mem_before);
+#endif
+#endif
 
-        if (current_lcp != 0) {
-          --current_lcp;
-        }
-      }
-    }
     // built rmq
-    m_rmq = alx::rmq::rmq_n<t_index_type>(m_lcp);
+#ifdef ALX_BENCHMARK_INTERNAL
+#ifdef ALX_BENCHMARK_SPACE
+    mem_before = malloc_count_current();
+#endif
+#endif
+    m_rmq = t_rmq(m_lcp);
+#ifdef ALX_BENCHMARK_INTERNAL
+    fmt::print(" rmq_time={}", t.get_and_reset());
+    if constexpr (requires { m_rmq.bits_per_element(); }) {
+      fmt::print(" rmq_bits_per_element={}", m_rmq.bits_per_element());
+    }
+#ifdef ALX_BENCHMARK_SPACE
+    fmt::print(" rmq_mem={}", malloc_count_current() - mem_before);
+#endif
+#endif
   }
 
   template <typename C>
@@ -130,7 +129,7 @@ class lce_classic {
 
   // Return {b, lce}, where lce is the number of common letters in text[i..]
   // and text[j..] and b tells whether the lce ends with a mismatch.
-  std::pair<bool, size_t> lce_mismatch(size_t i, size_t j) {
+  std::pair<bool, size_t> lce_mismatch(size_t i, size_t j) const {
     if (i == j) [[unlikely]] {
       assert(i < m_size);
       return {false, m_size - i};
@@ -144,7 +143,7 @@ class lce_classic {
 
   // Return whether text[i..] is lexicographic smaller than text[j..]. Here i
   // and j must be different.
-  bool is_leq_suffix(size_t i, size_t j) {
+  bool is_leq_suffix(size_t i, size_t j) const {
     assert(i != j);
     size_t lce_val = lce_uneq(i, j);
     return (
@@ -152,13 +151,116 @@ class lce_classic {
         ((j + lce_val != m_size) && m_text[i + lce_val] < m_text[j + lce_val]));
   }
 
+  // Return the comparison of text[i..] and text[j..], see suffix_comparison.
+  suffix_comparison<char_type> compare_suffixes(size_t i, size_t j) const {
+    size_t lce_val = lce(i, j);
+    return make_suffix_comparison(m_text, m_size, i, j, lce_val);
+  }
+
+  // Prefetch the ISA entries read by lce_lr(l, r).
+  void prefetch(size_t l, size_t r) const {
+    __builtin_prefetch(&m_isa[l]);
+    __builtin_prefetch(&m_isa[r]);
+  }
+
+  // Store the number of common letters in text[i..] and text[j..] in out[k]
+  // for each query (i, j) = queries[k]. Groups of queries are answered stage
+  // by stage, so the cache misses of one group overlap.
+  void lce_batch(std::span<const std::pair<size_t, size_t>> queries,
+                 std::span<size_t> out) const {
+    assert(out.size() >= queries.size());
+    std::array<size_t, m_batch_group_size> rank_i;
+    std::array<size_t, m_batch_group_size> rank_j;
+
+    for (size_t begin = 0; begin < queries.size();
+         begin += m_batch_group_size) {
+      size_t const end = std::min(begin + m_batch_group_size, queries.size());
+      // Stage 1: Prefetch the ISA entries.
+      for (size_t k = begin; k < end; ++k) {
+        prefetch(queries[k].first, queries[k].second);
+      }
+      // Stage 2: Look up the ranks and prefetch the RMQ.
+      for (size_t k = begin; k < end; ++k) {
+        auto const [i, j] = queries[k];
+        if (i == j) [[unlikely]] {
+          continue;
+        }
+        rank_i[k - begin] = m_isa[i];
+        rank_j[k - begin] = m_isa[j];
+        m_rmq.prefetch_shifted(rank_i[k - begin], rank_j[k - begin]);
+      }
+      // Stage 3: Answer the queries.
+      for (size_t k = begin; k < end; ++k) {
+        auto const [i, j] = queries[k];
+        if (i == j) [[unlikely]] {
+          assert(i < m_size);
+          out[k] = m_size - i;
+          continue;
+        }
+        out[k] =
+            m_lcp[m_rmq.rmq_shifted(rank_i[k - begin], rank_j[k - begin])];
+      }
+    }
+  }
+
+  // Store the number of common letters in text[i..] and text[j..] in out[k]
+  // for each query (i, j) = queries[k], without building the data structure.
+  // The range minima over the LCP array are answered offline by a sweep, see
+  // rmq/rmq_offline.hpp, which reuses the memory of the ISA once the queries
+  // are mapped to ranks. No RMQ data structure is built.
+  static void lce_offline(char_type const* text, size_t size,
+                          std::span<const std::pair<size_t, size_t>> queries,
+                          std::span<size_t> out) {
+    assert(out.size() >= queries.size());
+    std::vector<t_index_type> lcp;
+    std::vector<t_index_type> isa;
+    {
+      std::vector<t_index_type> sa =
+          alx::suffix_sort::suffix_array<t_index_type, t_construction>(text,
+                                                                       size);
+      isa = alx::suffix_sort::inverse_suffix_array(sa);
+      lcp = alx::suffix_sort::lcp_array<t_construction>(text, size, sa, isa);
+    }
+
+    // Map each query to the range of the LCP array holding its minimum.
+    std::vector<std::pair<t_index_type, t_index_type>> ranges(queries.size());
+#pragma omp parallel for
+    for (size_t k = 0; k < queries.size(); ++k) {
+      auto const [i, j] = queries[k];
+      if (i == j) [[unlikely]] {
+        ranges[k] = {0, 0};
+        continue;
+      }
+      size_t const rank_i = isa[i];
+      size_t const rank_j = isa[j];
+      ranges[k] = {std::min(rank_i, rank_j) + 1, std::max(rank_i, rank_j)};
+    }
+
+    alx::rmq::rmq_offline(
+        lcp.data(), lcp.size(),
+        std::span<std::pair<t_index_type, t_index_type> const>(ranges),
+        isa.data(), [&](size_t k, size_t min) {
+          auto const [i, j] = queries[k];
+          out[k] = (i == j) ? size - i : static_cast<size_t>(lcp[min]);
+        });
+  }
+
+  template <typename C>
+  static void lce_offline(C const& container,
+                          std::span<const std::pair<size_t, size_t>> queries,
+                          std::span<size_t> out) {
+    lce_offline(container.data(), container.size(), queries, out);
+  }
+
  private:
+  static constexpr size_t m_batch_group_size = 16;
+
   std::vector<t_index_type> m_isa;
   std::vector<t_index_type> m_lcp;
 
   char_type const* m_text;
   size_t m_size;
-  alx::rmq::rmq_n<t_index_type> m_rmq;
+  t_rmq m_rmq;
 };
 
 }  // namespace alx::lce
@@ -0,0 +1,426 @@
+/*******************************************************************************
+ * alx/lce/lce_classic_compressed.hpp
+ *
+ * Copyright (C) 2026 Alexander Herlez <alexander.herlez@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#include <assert.h>
+#include <omp.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+#include "lce/suffix_comparison.hpp"
+#include "rmq/rmq_nlgn.hpp"
+#include "suffix_sort/suffix_array_construction.hpp"
+
+#ifdef ALX_BENCHMARK_INTERNAL
+#include <fmt/core.h>
+
+#include "util/timer.hpp"
+#endif
+
+namespace alx::lce {
+
+// Space efficient variant of lce_classic. Instead of the LCP array, the
+// permuted LCP array (PLCP) is stored as a bitvector of 2n bits, in which the
+// bit PLCP[i] + 2i is set for each text position i. Then LCP[k] is
+// select(SA[k]) - 2SA[k], so the suffix array is kept instead of the LCP array.
+//
+// The ISA is either stored completely (t_isa_sample_rate = 1), or it is
+// derived from the suffix array: The SA is a permutation, and we store a back
+// pointer every t_isa_sample_rate steps of each of its cycles. Then ISA[i] is
+// found with at most 2 * t_isa_sample_rate suffix array accesses.
+//
+// Range minima are answered with the minima of blocks of t_block_size LCP
+// values, the minima of superblocks of m_superblock_size blocks and a sparse
+// table over the superblocks. Only the partial blocks at the ends of a query
+// range are scanned, and only if they can contain a smaller value.
+//
+// The suffix array and the PLCP array are built with t_construction, see
+// suffix_sort/suffix_array_construction.hpp.
+template <typename t_char_type = uint8_t, typename t_index_type = uint32_t,
+          size_t t_isa_sample_rate = 8, size_t t_block_size = 64,
+          typename t_construction = alx::suffix_sort::gsaca_backend>
+class lce_classic_compressed {
+  static_assert(t_isa_sample_rate >= 1);
+  static_assert(t_block_size >= 1);
+
+ public:
+  typedef t_char_type char_type;
+
+  lce_classic_compressed() : m_text(nullptr), m_size(0) {
+  }
+
+  lce_classic_compressed(char_type const* text, size_t size)
+      : m_text(text), m_size(size) {
+    if (size == 0) {
+      return;
+    }
+#ifdef ALX_BENCHMARK_INTERNAL
+    alx::util::timer t;
+#endif
+    m_sa = alx::suffix_sort::suffix_array<t_index_type, t_construction>(text,
+                                                                        size);
+#ifdef ALX_BENCHMARK_INTERNAL
+    fmt::print(" sa_backend={} sa_time={}", t_construction::name,
+               t.get_and_reset());
+#endif
+
+    std::vector<t_index_type> plcp =
+        alx::suffix_sort::plcp_array<t_construction>(text, size, m_sa);
+#ifdef ALX_BENCHMARK_INTERNAL
+    fmt::print(" plcp_time={}", t.get_and_reset());
+#endif
+
+    build_plcp_bits(plcp);
+    build_minima(plcp);
+    plcp = std::vector<t_index_type>();
+#ifdef ALX_BENCHMARK_INTERNAL
+    fmt::print(" lcp_bits_time={}", t.get_and_reset());
+#endif
+
+    build_isa();
+#ifdef ALX_BENCHMARK_INTERNAL
+    fmt::print(" isa_time={}", t.get_and_reset());
+#endif
+  }
+
+  template <typename C>
+  lce_classic_compressed(C const& container)
+      : lce_classic_compressed(container.data(), container.size()) {
+  }
+
+  // Return the number of common letters in text[i..] and text[j..].
+  size_t lce(size_t i, size_t j) const {
+    if (i == j) [[unlikely]] {
+      assert(i < m_size);
+      return m_size - i;
+    }
+    return lce_uneq(i, j);
+  }
+
+  // Return the number of common letters in text[i..] and text[j..]. Here i and
+  // j must be different.
+  size_t lce_uneq(size_t i, size_t j) const {
+    assert(i != j);
+    return lce_ranks(isa(i), isa(j));
+  }
+
+  // Return the number of common letters in text[i..] and text[j..].
+  // Here l must be smaller than r.
+  size_t lce_lr(size_t l, size_t r) const {
+    return lce_uneq(l, r);
+  }
+
+  // Return {b, lce}, where lce is the number of common letters in text[i..]
+  // and text[j..] and b tells whether the lce ends with a mismatch.
+  std::pair<bool, size_t> lce_mismatch(size_t i, size_t j) const {
+    if (i == j) [[unlikely]] {
+      assert(i < m_size);
+      return {false, m_size - i};
+    }
+    size_t lce = lce_uneq(i, j);
+    return {std::max(i, j) + lce != m_size, lce};
+  }
+
+  // Return whether text[i..] is lexicographic smaller than text[j..]. Here i
+  // and j must be different. Only the ranks of the suffixes are needed.
+  bool is_leq_suffix(size_t i, size_t j) const {
+    assert(i != j);
+    return isa(i) < isa(j);
+  }
+
+  // Return the comparison of text[i..] and text[j..], see suffix_comparison.
+  suffix_comparison<char_type> compare_suffixes(size_t i, size_t j) const {
+    size_t lce_val = lce(i, j);
+    return make_suffix_comparison(m_text, m_size, i, j, lce_val);
+  }
+
+  // Return the rank of text[i..] among all suffixes.
+  size_t isa(size_t i) const {
+    if constexpr (t_isa_sample_rate == 1) {
+      return m_isa[i];
+    } else {
+      // Walk along the cycle of i until we reach the position x with SA[x] = i.
+      // At the first sampled position, we jump back at most t_isa_sample_rate
+      // steps.
+      size_t x = i;
+      bool jumped = false;
+      while (m_sa[x] != i) {
+        if (!jumped && is_isa_sample(x)) {
+          x = m_isa_back[isa_sample_rank(x)];
+          jumped = true;
+        } else {
+          x = m_sa[x];
+        }
+      }
+      return x;
+    }
+  }
+
+  // Return LCP[k], i.e., the lce of the suffixes of rank k-1 and k.
+  size_t lcp(size_t k) const {
+    size_t const pos = m_sa[k];
+    return select_plcp(pos) - 2 * pos;
+  }
+
+  size_t size() const {
+    return m_size;
+  }
+
+ private:
+  static constexpr size_t m_superblock_size = 16;
+  static constexpr size_t m_select_sample_rate = 64;
+  // Groups of m_select_sample_rate ones that span more bits than this are
+  // stored explicitly, so select never scans more than about 64 words.
+  static constexpr size_t m_max_select_span = 64 * 64;
+  static constexpr uint64_t m_sparse_flag = uint64_t{1} << 63;
+
+  char_type const* m_text;
+  size_t m_size;
+
+  std::vector<t_index_type> m_sa;
+
+  // The ISA, if t_isa_sample_rate = 1.
+  std::vector<t_index_type> m_isa;
+  // Otherwise, the sampled positions of the SA cycles, the number of samples
+  // before each word and the back pointer of each sample.
+  std::vector<uint64_t> m_isa_samples;
+  std::vector<uint64_t> m_isa_sample_ranks;
+  std::vector<t_index_type> m_isa_back;
+
+  // The PLCP bitvector, the position of every m_select_sample_rate'th one and
+  // the explicitly stored positions of sparse groups.
+  std::vector<uint64_t> m_plcp_bits;
+  std::vector<uint64_t> m_select_samples;
+  std::vector<uint64_t> m_sparse_selects;
+
+  std::vector<t_index_type> m_block_minima;
+  std::vector<t_index_type> m_superblock_minima;
+  alx::rmq::rmq_nlgn<t_index_type> m_superblock_rmq;
+
+  void build_plcp_bits(std::vector<t_index_type> const& plcp) {
+    m_plcp_bits.assign((2 * m_size) / 64 + 1, 0);
+    m_select_samples.resize((m_size - 1) / m_select_sample_rate + 1);
+    for (size_t i = 0; i < m_size; ++i) {
+      size_t const pos = plcp[i] + 2 * i;
+      m_plcp_bits[pos / 64] |= uint64_t{1} << (pos % 64);
+      if (i % m_select_sample_rate == 0) {
+        m_select_samples[i / m_select_sample_rate] = pos;
+      }
+    }
+
+    // Store the positions of sparse groups explicitly.
+    for (size_t s = 0; s < m_select_samples.size(); ++s) {
+      size_t const first = s * m_select_sample_rate;
+      size_t const last = std::min(first + m_select_sample_rate, m_size) - 1;
+      size_t const span = (plcp[last] + 2 * last) - m_select_samples[s];
+      if (span > m_max_select_span) {
+        m_select_samples[s] =
+            m_sparse_flag | (m_sparse_selects.size() / m_select_sample_rate);
+        for (size_t i = first; i < first + m_select_sample_rate; ++i) {
+          m_sparse_selects.push_back(i <= last ? plcp[i] + 2 * i : 0);
+        }
+      }
+    }
+  }
+
+  // Return the position of the i'th one (starting at 0) of the PLCP bitvector.
+  size_t select_plcp(size_t i) const {
+    uint64_t const sample = m_select_samples[i / m_select_sample_rate];
+    size_t rest = i % m_select_sample_rate;
+    if (sample & m_sparse_flag) [[unlikely]] {
+      return m_sparse_selects[(sample & ~m_sparse_flag) * m_select_sample_rate +
+                              rest];
+    }
+    size_t word = sample / 64;
+    uint64_t bits = m_plcp_bits[word] & (~uint64_t{0} << (sample % 64));
+    size_t ones = std::popcount(bits);
+    while (rest >= ones) {
+      rest -= ones;
+      bits = m_plcp_bits[++word];
+      ones = std::popcount(bits);
+    }
+    for (; rest > 0; --rest) {
+      bits &= bits - 1;
+    }
+    return word * 64 + std::countr_zero(bits);
+  }
+
+  void build_minima(std::vector<t_index_type> const& plcp) {
+    size_t const num_blocks = (m_size - 1) / t_block_size + 1;
+    m_block_minima.resize(num_blocks);
+#pragma omp parallel for
+    for (size_t b = 0; b < num_blocks; ++b) {
+      size_t const end = std::min((b + 1) * t_block_size, m_size);
+      size_t min = m_size;
+      for (size_t k = b * t_block_size; k < end; ++k) {
+        min = std::min<size_t>(min, plcp[m_sa[k]]);
+      }
+      m_block_minima[b] = min;
+    }
+
+    size_t const num_superblocks = (num_blocks - 1) / m_superblock_size + 1;
+    m_superblock_minima.resize(num_superblocks);
+#pragma omp parallel for
+    for (size_t s = 0; s < num_superblocks; ++s) {
+      size_t const end = std::min((s + 1) * m_superblock_size, num_blocks);
+      size_t min = m_size;
+      for (size_t b = s * m_superblock_size; b < end; ++b) {
+        min = std::min<size_t>(min, m_block_minima[b]);
+      }
+      m_superblock_minima[s] = min;
+    }
+    m_superblock_rmq = alx::rmq::rmq_nlgn<t_index_type>(m_superblock_minima);
+  }
+
+  void build_isa() {
+    if constexpr (t_isa_sample_rate == 1) {
+      m_isa.resize(m_size);
+#pragma omp parallel for
+      for (size_t k = 0; k < m_size; ++k) {
+        m_isa[m_sa[k]] = k;
+      }
+    } else {
+      // Sample every t_isa_sample_rate'th position of each cycle. Cycles that
+      // are not longer than t_isa_sample_rate are walked without samples. The
+      // cycles are walked twice, first to mark the samples and then to store
+      // the back pointers, so no temporary list of samples is needed.
+      std::vector<uint64_t> visited(m_size / 64 + 1, 0);
+      auto is_visited = [&visited](size_t x) {
+        return (visited[x / 64] >> (x % 64)) & 1;
+      };
+      auto visit = [&visited](size_t x) {
+        visited[x / 64] |= uint64_t{1} << (x % 64);
+      };
+
+      m_isa_samples.assign(m_size / 64 + 1, 0);
+      for (size_t start = 0; start < m_size; ++start) {
+        if (is_visited(start)) {
+          continue;
+        }
+        size_t x = start;
+        size_t length = 0;
+        do {
+          visit(x);
+          if (length % t_isa_sample_rate == 0) {
+            m_isa_samples[x / 64] |= uint64_t{1} << (x % 64);
+          }
+          x = m_sa[x];
+          ++length;
+        } while (x != start);
+        if (length <= t_isa_sample_rate) {
+          m_isa_samples[start / 64] &= ~(uint64_t{1} << (start % 64));
+        }
+      }
+
+      m_isa_sample_ranks.resize(m_isa_samples.size());
+      size_t rank = 0;
+      for (size_t w = 0; w < m_isa_samples.size(); ++w) {
+        m_isa_sample_ranks[w] = rank;
+        rank += std::popcount(m_isa_samples[w]);
+      }
+      m_isa_back.resize(rank);
+
+      std::fill(visited.begin(), visited.end(), 0);
+      for (size_t start = 0; start < m_size; ++start) {
+        if (is_visited(start)) {
+          continue;
+        }
+        size_t x = start;
+        size_t prev_sample = start;
+        do {
+          visit(x);
+          x = m_sa[x];
+          if (is_isa_sample(x)) {
+            m_isa_back[isa_sample_rank(x)] = prev_sample;
+            prev_sample = x;
+          }
+        } while (x != start);
+      }
+    }
+  }
+
+  bool is_isa_sample(size_t x) const {
+    return m_isa_samples[x / 64] & (uint64_t{1} << (x % 64));
+  }
+
+  // Return the number of sampled positions before x.
+  size_t isa_sample_rank(size_t x) const {
+    uint64_t const mask = (uint64_t{1} << (x % 64)) - 1;
+    return m_isa_sample_ranks[x / 64] +
+           std::popcount(m_isa_samples[x / 64] & mask);
+  }
+
+  // Return the lce of the suffixes with rank a and b. Here a and b must be
+  // different.
+  size_t lce_ranks(size_t a, size_t b) const {
+    assert(a != b);
+    size_t const left = std::min(a, b) + 1;
+    size_t const right = std::max(a, b);
+
+    size_t const left_block = left / t_block_size;
+    size_t const right_block = right / t_block_size;
+    if (left_block == right_block) {
+      return lcp_min_scan(left, right, m_size, m_block_minima[left_block]);
+    }
+    size_t min = m_size;
+    if (left_block + 1 < right_block) {
+      min = block_min(left_block + 1, right_block - 1);
+    }
+    // The partial blocks only have to be scanned if they can contain a
+    // smaller value.
+    if (m_block_minima[left_block] < min) {
+      min = lcp_min_scan(left, (left_block + 1) * t_block_size - 1, min,
+                         m_block_minima[left_block]);
+    }
+    if (m_block_minima[right_block] < min) {
+      min = lcp_min_scan(right_block * t_block_size, right, min,
+                         m_block_minima[right_block]);
+    }
+    return min;
+  }
+
+  // Return the minimum of min and LCP[left..right]. Stop as soon as the lower
+  // bound is reached.
+  size_t lcp_min_scan(size_t left, size_t right, size_t min,
+                      size_t lower_bound = 0) const {
+    for (size_t k = left; k <= right && min > lower_bound; ++k) {
+      min = std::min(min, lcp(k));
+    }
+    return min;
+  }
+
+  // Return the minimum of the blocks left_block..right_block.
+  size_t block_min(size_t left_block, size_t right_block) const {
+    size_t const left_super = left_block / m_superblock_size;
+    size_t const right_super = right_block / m_superblock_size;
+    size_t min = m_size;
+    if (left_super == right_super) {
+      for (size_t b = left_block; b <= right_block; ++b) {
+        min = std::min<size_t>(min, m_block_minima[b]);
+      }
+      return min;
+    }
+    if (left_super + 1 < right_super) {
+      min = m_superblock_minima[m_superblock_rmq.rmq(left_super + 1,
+                                                     right_super - 1)];
+    }
+    for (size_t b = left_block; b < (left_super + 1) * m_superblock_size;
+         ++b) {
+      min = std::min<size_t>(min, m_block_minima[b]);
+    }
+    for (size_t b = right_super * m_superblock_size; b <= right_block; ++b) {
+      min = std::min<size_t>(min, m_block_minima[b]);
+    }
+    return min;
+  }
+};
+
+}  // namespace alx::lce
@@ -8,14 +8,13 @@
 
 #pragma once
 #include <assert.h>
-#include <libsais.h>
-#include <libsais64.h>
 
 #include <cstdint>
-#include <gsaca-double-sort-par.hpp>
 
 #include "lce/lce_naive_wordwise.hpp"
 #include "rmq/rmq_n.hpp"
+#include "suffix_sort/suffix_array_construction.hpp"
+#include "util/blocked_scatter.hpp"
 
 #ifdef ALX_BENCHMARK_INTERNAL
 #include <fmt/core.h>
@@ -29,7 +28,14 @@
 
 namespace alx::lce {
 
-template <typename t_index_type, size_t t_tau>
+// The suffix array of the reduced fingerprints is built with t_construction,
+// see suffix_sort/suffix_array_construction.hpp. The LCP array is measured in
+// text characters, so it is computed here over sss: With Kasai's algorithm, or
+// from the PLCP array if t_construction::phi_lcp is set. Range minima over the
+// LCP array are answered by t_rmq.
+template <typename t_index_type, size_t t_tau,
+          typename t_construction = alx::suffix_sort::gsaca_backend,
+          typename t_rmq = alx::rmq::rmq_n<t_index_type, t_index_type>>
 class lce_classic_for_sss {
  public:
   lce_classic_for_sss() : m_size{0} {
@@ -39,45 +45,99 @@ class lce_classic_for_sss {
                       t_index_type const* reduced_fps, size_t reduced_fps_size,
                       std::vector<t_index_type> const& sss)
       : m_size(reduced_fps_size) {
-    std::vector<t_index_type> sa(reduced_fps_size);
     // sort sa
 #ifdef ALX_BENCHMARK_INTERNAL
     alx::util::timer t;
+    fmt::print(" sa_backend={} phi_lcp={}", t_construction::name,
+               t_construction::phi_lcp);
 #ifdef ALX_BENCHMARK_SPACE
     size_t mem_before = malloc_count_current();
     malloc_count_reset_peak();
 #endif
 #endif
-    gsaca_for_lce(reduced_fps, sa.data(), reduced_fps_size);
+    std::vector<t_index_type> sa =
+        alx::suffix_sort::suffix_array<t_index_type, t_construction>(
+            reduced_fps, reduced_fps_size);
 
 #ifdef ALX_BENCHMARK_INTERNAL
-    fmt::print(" gsaca_time={}", t.get_and_reset());
+    fmt::print(" sa_time={}", t.get_and_reset());
 #ifdef ALX_BENCHMARK_SPACE
-    fmt::print(" gsaca_mem={}", malloc_count_current() - mem_before);
-    fmt::print(" gsaca_mem_peak={}", malloc_count_peak() - mem_before);
+    fmt::print(" sa_mem={}", malloc_count_current() - mem_before);
+    fmt::print(" sa_mem_peak={}", malloc_count_peak() - mem_before);
 #endif
 #endif
 
     // build isa
-    m_isa.resize(reduced_fps_size);
-#pragma omp parallel for
-    for (size_t i = 0; i < sa.size(); ++i) {
-      m_isa[sa[i]] = i;
-    }
+    m_isa = alx::suffix_sort::inverse_suffix_array(sa);
 
     // build lcp
     m_lcp.resize(sa.size());
+    if constexpr (t_construction::phi_lcp) {
+      lcp_array_phi(text, text_size, sss, sa);
+    } else {
+      lcp_array_kasai(text, text_size, sss, sa);
+    }
+
+    // built rmq
+    m_rmq = t_rmq(m_lcp);
+  }
+
+  // Return the number of common letters in text[i..] and text[j..]. Here i and
+  // j must be different.
+  size_t lce_uneq(size_t i, size_t j) const {
+    assert(i != j);
+    return lce_lr(i, j);
+  }
+
+  // Return the number of common letters in text[i..] and text[j..].
+  // Here l must be smaller than r.
+  size_t lce_lr(size_t l, size_t r) const {
+    return m_lcp[m_rmq.rmq_shifted(m_isa[l], m_isa[r])];
+  }
+
+  // Prefetch the ISA entries read by lce_lr(l, r).
+  void prefetch(size_t l, size_t r) const {
+    __builtin_prefetch(&m_isa[l]);
+    __builtin_prefetch(&m_isa[r]);
+  }
+
+ private:
+  // Return the lce of text[sss[i]..] and text[sss[j]..] when it is at least
+  // known_lcp.
+  static size_t extend_lcp(uint8_t const* text, size_t text_size,
+                           std::vector<t_index_type> const& sss, size_t i,
+                           size_t j, size_t known_lcp) {
+    size_t const lcp =
+        known_lcp + lce_naive_wordwise<uint8_t>::lce_uneq(
+                        text, text_size, sss[i] + known_lcp,
+                        sss[j] + known_lcp);
+    assert(lce_naive_wordwise<uint8_t>::lce_uneq(text, text_size, sss[i],
+                                                 sss[j]) == lcp);
+    return lcp;
+  }
+
+  // Return a lower bound for the lcp of text[sss[i+1]..] when the one of
+  // text[sss[i]..] is lcp.
+  static size_t next_lcp(std::vector<t_index_type> const& sss, size_t i,
+                         size_t lcp) {
+    uint64_t diff = sss[i + 1] - sss[i];
+    return (lcp < 2 * t_tau + diff) ? 0 : lcp - diff;
+  }
+
+  // Build m_lcp with Kasai's algorithm.
+  void lcp_array_kasai(uint8_t const* text, size_t text_size,
+                       std::vector<t_index_type> const& sss,
+                       std::vector<t_index_type> const& sa) {
     m_lcp[0] = 0;
-    size_t current_lcp = 0;
 
 #pragma omp parallel
     {
       const int t = omp_get_thread_num();
       const int nt = omp_get_num_threads();
-      const size_t slice_size = reduced_fps_size / nt;
+      const size_t slice_size = m_size / nt;
 
       const size_t begin = t * slice_size;
-      const size_t end = (t < nt - 1) ? (t + 1) * slice_size : reduced_fps_size;
+      const size_t end = (t < nt - 1) ? (t + 1) * slice_size : m_size;
 
       size_t current_lcp = 0;
       for (size_t i{begin}; i < end; ++i) {
@@ -88,44 +148,61 @@ class lce_classic_for_sss {
         assert(suffix_array_pos != 0);
 
         size_t preceding_suffix_pos = sa[suffix_array_pos - 1];
-        current_lcp += lce_naive_wordwise<uint8_t>::lce_uneq(
-            text, text_size, sss[i] + current_lcp,
-            sss[preceding_suffix_pos] + current_lcp);
+        current_lcp = extend_lcp(text, text_size, sss, i, preceding_suffix_pos,
+                                 current_lcp);
         m_lcp[suffix_array_pos] = current_lcp;
-        assert(lce_naive_wordwise<uint8_t>::lce_uneq(
-                   text, text_size, sss[i], sss[preceding_suffix_pos]) ==
-               current_lcp);
-
-        uint64_t diff = sss[i + 1] - sss[i];
-        if (current_lcp < 2 * t_tau + diff) {
-          current_lcp = 0;
-        } else {
-          current_lcp -= diff;
-        }
+        current_lcp = next_lcp(sss, i, current_lcp);
       }
     }
-    // built rmq
-    m_rmq = alx::rmq::rmq_n<t_index_type>(m_lcp);
   }
 
-  // Return the number of common letters in text[i..] and text[j..]. Here i and
-  // j must be different.
-  size_t lce_uneq(size_t i, size_t j) const {
-    assert(i != j);
-    return lce_lr(i, j);
-  }
+  // Build m_lcp from the PLCP array, which is computed in text order with the
+  // help of the PHI array and then permuted with one blocked scatter. See
+  // suffix_sort/suffix_array_construction.hpp.
+  void lcp_array_phi(uint8_t const* text, size_t text_size,
+                     std::vector<t_index_type> const& sss,
+                     std::vector<t_index_type> const& sa) {
+    std::vector<t_index_type> plcp(m_size);
+    alx::util::blocked_scatter(
+        m_size, plcp.data(), m_size,
+        [&sa](size_t k) { return static_cast<size_t>(sa[k]); },
+        [&sa, this](size_t k) {
+          return (k == 0) ? m_size : static_cast<size_t>(sa[k - 1]);
+        });
 
-  // Return the number of common letters in text[i..] and text[j..].
-  // Here l must be smaller than r.
-  size_t lce_lr(size_t l, size_t r) const {
-    return m_lcp[m_rmq.rmq_shifted(m_isa[l], m_isa[r])];
+#pragma omp parallel
+    {
+      const int t = omp_get_thread_num();
+      const int nt = omp_get_num_threads();
+      const size_t slice_size = m_size / nt;
+
+      const size_t begin = t * slice_size;
+      const size_t end = (t < nt - 1) ? (t + 1) * slice_size : m_size;
+
+      size_t current_lcp = 0;
+      for (size_t i{begin}; i < end; ++i) {
+        size_t const preceding_suffix_pos = plcp[i];
+        if (preceding_suffix_pos == m_size) {
+          plcp[i] = 0;
+          current_lcp = 0;
+          continue;
+        }
+        current_lcp = extend_lcp(text, text_size, sss, i, preceding_suffix_pos,
+                                 current_lcp);
+        plcp[i] = current_lcp;
+        current_lcp = next_lcp(sss, i, current_lcp);
+      }
+    }
+    alx::util::blocked_scatter(
+        m_size, m_lcp.data(), m_size,
+        [this](size_t i) { return static_cast<size_t>(m_isa[i]); },
+        [&plcp](size_t i) { return plcp[i]; });
   }
 
- private:
   size_t m_size;
   std::vector<t_index_type> m_isa;
   std::vector<t_index_type> m_lcp;
-  alx::rmq::rmq_n<t_index_type> m_rmq;
+  t_rmq m_rmq;
 };
 
 }  // namespace alx::lce
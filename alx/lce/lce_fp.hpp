@@ -13,22 +13,41 @@
 #include <array>
 #include <bit>
 #include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
 
+#include "lce/suffix_comparison.hpp"
 #include "rolling_hash/modular_arithmetic.hpp"
 
 namespace alx::lce {
 
-template <typename t_char_type = uint8_t, size_t t_naive_scan = 32>
+// If t_in_place is true, the text is overwritten with the fingerprints and
+// restored by the destructor. Otherwise, the fingerprints are stored in a
+// separate array and the text is only read, so it may be read-only (e.g.
+// memory mapped) and shared with other data structures.
+template <typename t_char_type = uint8_t, size_t t_naive_scan = 32,
+          bool t_in_place = true>
 class lce_fp {
  public:
   typedef t_char_type char_type;
+  typedef std::conditional_t<t_in_place, char_type*, char_type const*>
+      text_pointer_type;
   __extension__ typedef unsigned __int128 uint128_t;
 
+  // The characters text[i+lce] and text[j+lce] following an lce, as decoded
+  // by the scan that found the mismatch.
+  struct mismatch_chars {
+    char_type i = 0;
+    char_type j = 0;
+  };
+
   lce_fp() : m_block_fps(nullptr), m_size(0) {
   }
 
-  lce_fp(char_type* text, size_t size)
-      : m_block_fps(reinterpret_cast<uint64_t*>(text)), m_size(size) {
+  lce_fp(text_pointer_type text, size_t size) : m_size(size) {
     assert(size % 8 == 0);
     size_t size_in_blocks{size / 8};
     assert(sizeof(t_char_type) == 1);
@@ -37,11 +56,26 @@ class lce_fp {
 
     // For small endian systems we need to swap the order of bytes in order to
     // calculate fingerprints. Luckily this step is fast.
-    if constexpr (std::endian::native == std::endian::little) {
+    if constexpr (t_in_place) {
+      m_block_fps = reinterpret_cast<uint64_t*>(text);
+      if constexpr (std::endian::native == std::endian::little) {
+#pragma omp parallel for
+        for (size_t i = 0; i < size_in_blocks; ++i) {
+          m_block_fps[i] =
+              __builtin_bswap64(m_block_fps[i]);  // C++23 std::byteswap!
+        }
+      }
+    } else {
+      m_fp_storage = std::make_unique_for_overwrite<uint64_t[]>(size_in_blocks);
+      m_block_fps = m_fp_storage.get();
 #pragma omp parallel for
       for (size_t i = 0; i < size_in_blocks; ++i) {
-        m_block_fps[i] =
-            __builtin_bswap64(m_block_fps[i]);  // C++23 std::byteswap!
+        uint64_t block;
+        std::memcpy(&block, text + 8 * i, sizeof(uint64_t));
+        if constexpr (std::endian::native == std::endian::little) {
+          block = __builtin_bswap64(block);
+        }
+        m_block_fps[i] = block;
       }
     }
 
@@ -114,7 +148,11 @@ class lce_fp {
 
   // move constructor
   lce_fp(lce_fp&& other)
-      : m_block_fps(other.m_block_fps), m_size(other.m_size) {
+      : m_block_fps(other.m_block_fps),
+        m_size(other.m_size),
+        m_fp_storage(std::move(other.m_fp_storage)) {
+    other.m_block_fps = nullptr;
+    other.m_size = 0;
   }
 
   // copy assignment
@@ -122,20 +160,52 @@ class lce_fp {
 
   // move assignment
   lce_fp& operator=(lce_fp&& other) noexcept {
+    retransform_text();
     m_block_fps = other.m_block_fps;
     m_size = other.m_size;
+    m_fp_storage = std::move(other.m_fp_storage);
+    other.m_block_fps = nullptr;
+    other.m_size = 0;
     return *this;
   }
 
+  // Restore the original text, if it was overwritten. Afterwards, no queries
+  // can be answered.
   void retransform_text() {
-    if (m_block_fps != nullptr) {
-      for (size_t i{(m_size / 8) - 1}; i > 0; --i) {
-        m_block_fps[i] = get_block_not_first(i);
-        m_block_fps[i] = __builtin_bswap64(m_block_fps[i]);
+    if (m_block_fps == nullptr) {
+      return;
+    }
+    if constexpr (t_in_place) {
+      size_t const size_in_blocks = m_size / 8;
+      std::vector<uint64_t> boundary_fps(omp_get_max_threads() + 1);
+#pragma omp parallel
+      {
+        int t = omp_get_thread_num();
+        int nt = omp_get_num_threads();
+        uint64_t slice_size = size_in_blocks / nt;
+        size_t begin = t * slice_size;
+        size_t end = (t < nt - 1) ? (t + 1) * slice_size : size_in_blocks;
+
+        // Block i is decoded with the fingerprint of block i-1, which may lie
+        // in the slice of the previous thread. Save it before any block is
+        // restored.
+        boundary_fps[t] =
+            (begin != 0 && begin < end)
+                ? m_block_fps[begin - 1] & 0x7FFFFFFFFFFFFFFFULL
+                : 0;
+#pragma omp barrier
+        for (size_t i{end}; i > begin; --i) {
+          uint64_t const prev_fingerprint =
+              (i - 1 == begin) ? boundary_fps[t]
+                               : m_block_fps[i - 2] & 0x7FFFFFFFFFFFFFFFULL;
+          m_block_fps[i - 1] =
+              __builtin_bswap64(decode_block(i - 1, prev_fingerprint));
+        }
       }
-      m_block_fps[0] &= 0x7FFFFFFFFFFFFFFFULL;
-      m_block_fps[0] = __builtin_bswap64(m_block_fps[0]);
     }
+    m_block_fps = nullptr;
+    m_size = 0;
+    m_fp_storage.reset();
   }
 
   char_type operator[](size_t pos) const {
@@ -166,40 +236,15 @@ class lce_fp {
 
   // Return the number of common letters in text[i..] and text[j..].
   // Here l must be smaller than r.
-  size_t lce_lr(size_t l, size_t r) const {
+  // If mismatch is not null, the characters following the lce are stored in
+  // it.
+  size_t lce_lr(size_t l, size_t r, mismatch_chars* mismatch = nullptr) const {
     uint64_t max_lce = m_size - r;
-    uint64_t lce = lce_scan(l, r, max_lce);
+    uint64_t lce = lce_scan(l, r, max_lce, mismatch);
     if (lce < t_naive_scan) {
       return lce;
     }
-    // Exponential search
-    uint64_t dist = t_naive_scan * 2;
-    int exp = std::countr_zero(dist);
-
-    const uint128_t fingerprint_to_l = (l != 0) ? fp_to(l - 1) : 0;
-    const uint128_t fingerprint_to_r = (r != 0) ? fp_to(r - 1) : 0;
-
-    while (dist <= max_lce && fp_exp(fingerprint_to_l, l, exp) ==
-                                  fp_exp(fingerprint_to_r, r, exp)) {
-      ++exp;
-      dist *= 2;
-    }
-
-    // Binary search. We start it at i2 and j2, because we know that up until
-    // i2 and j2 everything matched.
-    --exp;
-    dist /= 2;
-    uint64_t add = dist;
-
-    while (dist > t_naive_scan) {
-      --exp;
-      dist /= 2;
-      if (fp_exp(l + add, exp) == fp_exp(r + add, exp)) {
-        add += dist;
-      }
-    }
-    max_lce -= add;
-    return add + lce_scan_to_end(l + add, r + add, max_lce);
+    return lce_exponential_search(l, r, max_lce, mismatch);
   }
 
   // Return {b, lce}, where lce is the number of common letters in text[i..]
@@ -228,9 +273,85 @@ class lce_fp {
                                                                      lce_val));
   }
 
+  // Return the comparison of text[i..] and text[j..], see suffix_comparison.
+  suffix_comparison<char_type> compare_suffixes(size_t i, size_t j) const {
+    if (i == j) [[unlikely]] {
+      assert(i < m_size);
+      return make_suffix_comparison<char_type>(m_size, i, j, m_size - i, 0, 0);
+    }
+    size_t l = std::min(i, j);
+    size_t r = std::max(i, j);
+
+    mismatch_chars mismatch;
+    size_t lce_val = lce_lr(l, r, &mismatch);
+    return (i < j) ? make_suffix_comparison(m_size, i, j, lce_val, mismatch.i,
+                                            mismatch.j)
+                   : make_suffix_comparison(m_size, i, j, lce_val, mismatch.j,
+                                            mismatch.i);
+  }
+
+  // Prefetch the fingerprints read by the naive scan of lce_lr(l, r).
+  void prefetch(size_t l, size_t r) const {
+    __builtin_prefetch(m_block_fps + (l / 8));
+    __builtin_prefetch(m_block_fps + (r / 8));
+    if (l >= 8) {
+      __builtin_prefetch(m_block_fps + (l / 8) - 1);
+    }
+    if (r >= 8) {
+      __builtin_prefetch(m_block_fps + (r / 8) - 1);
+    }
+  }
+
+  // Store the number of common letters in text[i..] and text[j..] in out[k]
+  // for each query (i, j) = queries[k]. Groups of queries are answered stage
+  // by stage, so the cache misses of one group overlap.
+  void lce_batch(std::span<const std::pair<size_t, size_t>> queries,
+                 std::span<size_t> out) const {
+    assert(out.size() >= queries.size());
+    std::array<pending_query, m_batch_group_size> pending;
+
+    for (size_t begin = 0; begin < queries.size();
+         begin += m_batch_group_size) {
+      size_t const end = std::min(begin + m_batch_group_size, queries.size());
+      // Stage 1: Prefetch the fingerprints read by the naive scan.
+      for (size_t k = begin; k < end; ++k) {
+        auto const [i, j] = queries[k];
+        prefetch(std::min(i, j), std::max(i, j));
+      }
+      // Stage 2: Scan the first t_naive_scan characters. For the remaining
+      // queries prefetch the fingerprints of the first exponential step.
+      size_t num_pending = 0;
+      for (size_t k = begin; k < end; ++k) {
+        auto const [i, j] = queries[k];
+        if (i == j) [[unlikely]] {
+          assert(i < m_size);
+          out[k] = m_size - i;
+          continue;
+        }
+        pending_query& q = pending[num_pending];
+        q.k = k;
+        q.l = std::min(i, j);
+        q.r = std::max(i, j);
+        out[k] = lce_scan(q.l, q.r, m_size - q.r);
+        if (out[k] == t_naive_scan) {
+          if (2 * t_naive_scan <= m_size - q.r) {
+            __builtin_prefetch(m_block_fps + (q.l + 2 * t_naive_scan - 1) / 8);
+            __builtin_prefetch(m_block_fps + (q.r + 2 * t_naive_scan - 1) / 8);
+          }
+          ++num_pending;
+        }
+      }
+      // Stage 3: Answer the remaining queries.
+      for (size_t p = 0; p < num_pending; ++p) {
+        pending_query const& q = pending[p];
+        out[q.k] = lce_exponential_search(q.l, q.r, m_size - q.r);
+      }
+    }
+  }
+
   // Alternative: Calculate influence, and compare fp - influence until mismatch
-  uint64_t lce_scan(const uint64_t i, const uint64_t j,
-                    uint64_t max_lce) const {
+  uint64_t lce_scan(const uint64_t i, const uint64_t j, uint64_t max_lce,
+                    mismatch_chars* mismatch = nullptr) const {
     uint64_t lce = 0;
     // Naive part of lce query. Compare blockwise.
     const int offset_lce1 = (i % 8) * 8;
@@ -264,15 +385,17 @@ class lce_fp {
     // and return the result
     if (lce != t_naive_scan) {
       uint64_t max_stub = std::min((max_lce - lce), uint64_t{8});
-      return lce + std::min<uint64_t>(
-                       ((std::countl_zero(comp_block_i ^ comp_block_j)) / 8),
-                       max_stub);
+      return lce + lce_stub(comp_block_i, comp_block_j, max_stub, mismatch);
     }
     return t_naive_scan;
   }
 
   uint64_t lce_scan_to_end(const uint64_t i, const uint64_t j,
-                           uint64_t max_lce) const {
+                           uint64_t max_lce,
+                           mismatch_chars* mismatch = nullptr) const {
+    if (max_lce == 0) {
+      return 0;
+    }
     uint64_t lce = 0;
     // Naive part of lce query. Compare blockwise.
     const int offset_lce1 = (i % 8) * 8;
@@ -286,7 +409,7 @@ class lce_fp {
     uint64_t comp_block_j =
         (block_j << offset_lce2) + ((block_j2 >> 1) >> (63 - offset_lce2));
 
-    while (lce < max_lce) {
+    while (lce < max_lce / 8) {
       if (comp_block_i != comp_block_j) {
         break;
       }
@@ -305,16 +428,14 @@ class lce_fp {
     // and return the result.
 
     uint64_t max_stub = std::min((max_lce - lce), uint64_t{8});
-    return lce +
-           std::min<uint64_t>(
-               ((std::countl_zero(comp_block_i ^ comp_block_j)) / 8), max_stub);
+    return lce + lce_stub(comp_block_i, comp_block_j, max_stub, mismatch);
   }
 
   // Return the lce of text[i..i+lce) and text[j..j+lce]
   size_t lce_up_to(size_t i, size_t j, size_t up_to) const {
     if (i == j) [[unlikely]] {
       assert(i < m_size);
-      m_size - i;
+      return m_size - i;
     }
 
     size_t l = std::min(i, j);
@@ -325,42 +446,61 @@ class lce_fp {
     if (lce < t_naive_scan) {
       return lce;
     }
-    // Exponential search
-    uint64_t dist = t_naive_scan * 2;
-    int exp = std::countr_zero(dist);
-
-    const uint128_t fingerprint_to_l = (l != 0) ? fp_to(l - 1) : 0;
-    const uint128_t fingerprint_to_r = (r != 0) ? fp_to(r - 1) : 0;
+    return lce_exponential_search(l, r, max_lce);
+  }
 
-    while (dist <= max_lce && fp_exp(fingerprint_to_l, l, exp) ==
-                                  fp_exp(fingerprint_to_r, r, exp)) {
-      ++exp;
-      dist *= 2;
+  // Store the number of common letters in text[pivot..] and text[others[k]..]
+  // in out[k]. The fingerprints of text[pivot..pivot+2^e) used by the
+  // exponential search are computed only once for all queries.
+  void lce_many(size_t pivot, std::span<const size_t> others,
+                std::span<size_t> out) const {
+    assert(out.size() >= others.size());
+    pivot_fps pivot_cache(pivot);
+    for (size_t k = 0; k < others.size(); ++k) {
+      out[k] = lce_pivot(pivot_cache, others[k]);
     }
+  }
 
-    // Binary search. We start it at i2 and j2, because we know that up until
-    // i2 and j2 everything matched.
-    --exp;
-    dist /= 2;
-    uint64_t add = dist;
-
-    while (dist > t_naive_scan) {
-      --exp;
-      dist /= 2;
-      if (fp_exp(l + add, exp) == fp_exp(r + add, exp)) {
-        add += dist;
-      }
+  // Store in out[k] whether text[others[k]..] is lexicographic smaller than
+  // text[pivot..]. Here others[k] must be different from pivot.
+  void is_leq_suffix_many(size_t pivot, std::span<const size_t> others,
+                          std::span<uint8_t> out) const {
+    assert(out.size() >= others.size());
+    pivot_fps pivot_cache(pivot);
+    for (size_t k = 0; k < others.size(); ++k) {
+      size_t const i = others[k];
+      assert(i != pivot);
+      size_t const lce_val = lce_pivot(pivot_cache, i);
+      out[k] = i + lce_val == m_size ||
+               ((pivot + lce_val != m_size) &&
+                operator[](i + lce_val) < operator[](pivot + lce_val));
     }
-    max_lce -= add;
-    lce = add + lce_scan_to_end(l + add, r + add, max_lce);
-
-    return lce;
   }
 
  private:
   uint64_t* m_block_fps = nullptr;
   size_t m_size = 0;
+  // Owns the fingerprints if they are not stored in place of the text.
+  std::unique_ptr<uint64_t[]> m_fp_storage;
   static constexpr uint128_t m_prime{0x800000000000001d};
+  static constexpr size_t m_batch_group_size = 16;
+
+  // A query of lce_batch, whose lce exceeds the first t_naive_scan characters.
+  struct pending_query {
+    size_t k, l, r;
+  };
+
+  // The fingerprints of text[pos..pos+2^e) of a pivot, computed on first use.
+  struct pivot_fps {
+    size_t pos;
+    bool has_fingerprint_to = false;
+    uint128_t fingerprint_to = 0;
+    int num_exp = std::countr_zero(t_naive_scan * 2);
+    std::array<uint64_t, 64> fps;
+
+    pivot_fps(size_t pivot) : pos(pivot) {
+    }
+  };
 
   // Calculates the powers of 2. This supports LCE queries and reduces the time
   // from polylogarithmic to logarithmic.
@@ -377,9 +517,10 @@ class lce_fp {
   static constexpr std::array<uint64_t, 70> m_power_table =
       calculate_power_table();
 
-  // Return the i'th block. A block contains 8 character.
-  uint64_t get_block(const uint64_t i) const {
-    uint128_t x = (i != 0) ? m_block_fps[i - 1] & 0x7FFFFFFFFFFFFFFFULL : 0;
+  // Return the i'th block, when the fingerprint up to block i-1 is known.
+  uint64_t decode_block(const uint64_t i,
+                        const uint64_t prev_fingerprint) const {
+    uint128_t x = prev_fingerprint;
     x <<= 64;
     x %= m_prime;
 
@@ -394,25 +535,19 @@ class lce_fp {
     return y + s_bit * static_cast<uint64_t>(m_prime);
   }
 
+  // Return the i'th block. A block contains 8 character.
+  uint64_t get_block(const uint64_t i) const {
+    return decode_block(
+        i, (i != 0) ? m_block_fps[i - 1] & 0x7FFFFFFFFFFFFFFFULL : 0);
+  }
+
   // Return the i'th block for i > 0.
   uint64_t get_block_not_first(const uint64_t i) const {
     assert(i >= 1);
     if (i >= m_size / 8) {
       return 0;
     }
-    uint128_t x = m_block_fps[i - 1] & 0x7FFFFFFFFFFFFFFFULL;
-    x <<= 64;
-    x %= m_prime;
-
-    uint64_t current_fingerprint = m_block_fps[i];
-    uint64_t s_bit = current_fingerprint >> 63;
-    current_fingerprint &= 0x7FFFFFFFFFFFFFFFULL;
-
-    uint64_t y = static_cast<uint64_t>(x);
-
-    y = y <= current_fingerprint ? current_fingerprint - y
-                                 : m_prime - (y - current_fingerprint);
-    return y + s_bit * static_cast<uint64_t>(m_prime);
+    return decode_block(i, m_block_fps[i - 1] & 0x7FFFFFFFFFFFFFFFULL);
   }
 
   uint128_t fp_to(size_t i) const {
@@ -469,5 +604,101 @@ class lce_fp {
                : static_cast<uint64_t>(m_prime -
                                        (fingerprint_to_i - fingerprint_to_j));
   }
+
+  // Return the fingerprint of text[pivot.pos..pivot.pos+2^exp).
+  uint64_t fp_exp(pivot_fps& pivot, const int exp) const {
+    if (!pivot.has_fingerprint_to) {
+      pivot.fingerprint_to = (pivot.pos != 0) ? fp_to(pivot.pos - 1) : 0;
+      pivot.has_fingerprint_to = true;
+    }
+    while (pivot.num_exp <= exp) {
+      pivot.fps[pivot.num_exp] =
+          fp_exp(pivot.fingerprint_to, pivot.pos, pivot.num_exp);
+      ++pivot.num_exp;
+    }
+    return pivot.fps[exp];
+  }
+
+  // Return the number of common letters in text[pivot.pos..] and text[i..].
+  size_t lce_pivot(pivot_fps& pivot, size_t i) const {
+    if (i == pivot.pos) [[unlikely]] {
+      assert(i < m_size);
+      return m_size - i;
+    }
+    size_t l = std::min(i, pivot.pos);
+    size_t r = std::max(i, pivot.pos);
+
+    uint64_t max_lce = m_size - r;
+    uint64_t lce = lce_scan(l, r, max_lce);
+    if (lce < t_naive_scan) {
+      return lce;
+    }
+    // Exponential search
+    uint64_t dist = t_naive_scan * 2;
+    int exp = std::countr_zero(dist);
+
+    const uint128_t fingerprint_to_i = (i != 0) ? fp_to(i - 1) : 0;
+
+    while (dist <= max_lce &&
+           fp_exp(pivot, exp) == fp_exp(fingerprint_to_i, i, exp)) {
+      ++exp;
+      dist *= 2;
+    }
+    return lce_binary_search(l, r, max_lce, exp, dist);
+  }
+
+  // Return the number of common leading characters of the blocks a and b, but
+  // at most max_stub. The first mismatching characters are stored in mismatch.
+  static uint64_t lce_stub(uint64_t a, uint64_t b, uint64_t max_stub,
+                           mismatch_chars* mismatch) {
+    uint64_t stub = std::min<uint64_t>(std::countl_zero(a ^ b) / 8, max_stub);
+    if (mismatch != nullptr && stub < 8) {
+      mismatch->i = static_cast<char_type>(a >> (56 - 8 * stub));
+      mismatch->j = static_cast<char_type>(b >> (56 - 8 * stub));
+    }
+    return stub;
+  }
+
+  // Return the lce of text[l..] and text[r..], but at most max_lce, when the
+  // first t_naive_scan characters are known to match.
+  uint64_t lce_exponential_search(const uint64_t l, const uint64_t r,
+                                  uint64_t max_lce,
+                                  mismatch_chars* mismatch = nullptr) const {
+    uint64_t dist = t_naive_scan * 2;
+    int exp = std::countr_zero(dist);
+
+    const uint128_t fingerprint_to_l = (l != 0) ? fp_to(l - 1) : 0;
+    const uint128_t fingerprint_to_r = (r != 0) ? fp_to(r - 1) : 0;
+
+    while (dist <= max_lce && fp_exp(fingerprint_to_l, l, exp) ==
+                                  fp_exp(fingerprint_to_r, r, exp)) {
+      ++exp;
+      dist *= 2;
+    }
+    return lce_binary_search(l, r, max_lce, exp, dist, mismatch);
+  }
+
+  // Finish an lce query after the exponential search failed at distance dist =
+  // 2^exp, so text[l..l+dist/2) and text[r..r+dist/2) match.
+  uint64_t lce_binary_search(const uint64_t l, const uint64_t r,
+                             uint64_t max_lce, int exp, uint64_t dist,
+                             mismatch_chars* mismatch = nullptr) const {
+    // Binary search. We start it at i2 and j2, because we know that up until
+    // i2 and j2 everything matched.
+    --exp;
+    dist /= 2;
+    uint64_t add = dist;
+
+    while (dist > t_naive_scan) {
+      --exp;
+      dist /= 2;
+      if (add + dist <= max_lce &&
+          fp_exp(l + add, exp) == fp_exp(r + add, exp)) {
+        add += dist;
+      }
+    }
+    max_lce -= add;
+    return add + lce_scan_to_end(l + add, r + add, max_lce, mismatch);
+  }
 };  // namespace alx::lce
 }  // namespace alx::lce
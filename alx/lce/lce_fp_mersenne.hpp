@@ -0,0 +1,123 @@
+/*******************************************************************************
+ * alx/lce/lce_fp_mersenne.hpp
+ *
+ * Copyright (C) 2022 Alexander Herlez <alexander.herlez@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#include <assert.h>
+#include <omp.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "lce/lce_fp_mersenne_base.hpp"
+
+namespace alx::lce {
+
+// Fingerprinting LCE data structure like lce_fp, but modulo the mersenne prime
+// 2^61-1, so that no 128-bit division is needed. The queries and the
+// fingerprints are shared with lce_fp_sampled, see lce_fp_mersenne_base.
+//
+// The prefix fingerprint up to each 64-bit block of the text is stored in a
+// separate array, and the text is left untouched. Overwriting the text like
+// lce_fp does would require the base 256, because a block is only recovered
+// from two consecutive fingerprints if it is its own digit.
+template <typename t_char_type = uint8_t, size_t t_naive_scan = 32>
+class lce_fp_mersenne
+    : public lce_fp_mersenne_base<lce_fp_mersenne<t_char_type, t_naive_scan>,
+                                  t_char_type, t_naive_scan> {
+  typedef lce_fp_mersenne_base<lce_fp_mersenne, t_char_type, t_naive_scan>
+      base_type;
+  friend base_type;
+
+ public:
+  typedef t_char_type char_type;
+
+  lce_fp_mersenne() {
+  }
+
+  lce_fp_mersenne(char_type const* text, size_t size) : base_type(text, size) {
+    size_t size_in_blocks{size / 8};
+    m_fps = std::make_unique_for_overwrite<uint64_t[]>(size_in_blocks);
+    std::vector<uint64_t> superblock_fps(omp_get_max_threads());
+
+#pragma omp parallel
+    {
+      int t = omp_get_thread_num();
+      int nt = omp_get_num_threads();
+      uint64_t slice_size = size_in_blocks / nt;
+      size_t begin = t * slice_size;
+      size_t end = (t < nt - 1) ? (t + 1) * slice_size : size_in_blocks;
+
+      // First calculate FP of superblock.
+      if (t != nt - 1) {
+        uint64_t fingerprint = 0;
+        for (size_t i = begin; i < end; ++i) {
+          fingerprint = this->append_block(fingerprint, this->get_block(i));
+        }
+        superblock_fps[t + 1] = fingerprint;
+      }
+    }
+
+    // Prefix sum over fingerprints of superblocks.
+    uint64_t slice_size = size_in_blocks / omp_get_max_threads();
+    uint64_t const shift = mersenne::pow_mod<uint64_t, m_prime>(
+        this->m_block_power, slice_size);
+    for (size_t i = 1; i < superblock_fps.size(); ++i) {
+      superblock_fps[i] = mersenne::add_mod<uint64_t, m_prime>(
+          mersenne::mult_mod<uint64_t, m_prime>(superblock_fps[i - 1], shift),
+          superblock_fps[i]);
+    }
+
+#pragma omp parallel
+    {
+      int t = omp_get_thread_num();
+      int nt = omp_get_num_threads();
+      uint64_t slice_size = size_in_blocks / nt;
+      size_t begin = t * slice_size;
+      size_t end = (t < nt - 1) ? (t + 1) * slice_size : size_in_blocks;
+
+      uint64_t fingerprint = superblock_fps[t];
+      for (size_t i = begin; i < end; ++i) {
+        fingerprint = this->append_block(fingerprint, this->get_block(i));
+        m_fps[i] = fingerprint;
+      }
+    }
+  }
+
+  template <typename C>
+  lce_fp_mersenne(C const& container)
+      : lce_fp_mersenne(container.data(), container.size()) {
+  }
+
+  // Free the fingerprints. The text is never changed. Afterwards, no queries
+  // can be answered.
+  void retransform_text() {
+    this->m_text = nullptr;
+    this->m_size = 0;
+    m_fps.reset();
+  }
+
+ private:
+  using base_type::m_prime;
+
+  // The fingerprint of the text up to and including each block.
+  std::unique_ptr<uint64_t[]> m_fps;
+
+  // Return the fingerprint of the first b blocks.
+  uint64_t fp_blocks(size_t b) const {
+    return (b != 0) ? m_fps[b - 1] : 0;
+  }
+
+  // Prefetch what fp_blocks(b) reads.
+  void prefetch_fp_blocks(size_t b) const {
+    if (b != 0) {
+      __builtin_prefetch(&m_fps[b - 1]);
+    }
+  }
+};
+}  // namespace alx::lce
@@ -0,0 +1,379 @@
+/*******************************************************************************
+ * alx/lce/lce_fp_mersenne_base.hpp
+ *
+ * Copyright (C) 2026 Alexander Herlez <alexander.herlez@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#include <assert.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <span>
+#include <utility>
+
+#include "lce/suffix_comparison.hpp"
+#include "rolling_hash/mersenne_modular_arithmetic.hpp"
+
+namespace alx::lce {
+
+// Queries of the fingerprinting LCE data structures that keep the text as it
+// is and work modulo the mersenne prime 2^61-1 (lce_fp_mersenne and
+// lce_fp_sampled). The fingerprint of a string s is sum s[k] * base^(|s|-1-k)
+// for a base that is drawn at random at construction. (A fixed base like 256
+// has a small order modulo 2^61-1, so there would be strings that always
+// collide.)
+//
+// The derived class t_derived stores some of the prefix fingerprints of the
+// blocks of 8 characters. It provides fp_blocks(b), the fingerprint of the
+// first b blocks, and prefetch_fp_blocks(b), which prefetches what fp_blocks(b)
+// reads.
+template <typename t_derived, typename t_char_type, size_t t_naive_scan>
+class lce_fp_mersenne_base {
+ public:
+  typedef t_char_type char_type;
+
+  char_type operator[](size_t pos) const {
+    assert(pos < m_size);
+    return m_text[pos];
+  }
+
+  // Return the number of common letters in text[i..] and text[j..].
+  size_t lce(size_t i, size_t j) const {
+    if (i == j) [[unlikely]] {
+      assert(i < m_size);
+      return m_size - i;
+    }
+    return lce_uneq(i, j);
+  }
+
+  // Return the number of common letters in text[i..] and text[j..]. Here i and
+  // j must be different.
+  size_t lce_uneq(size_t i, size_t j) const {
+    assert(i != j);
+
+    size_t l = std::min(i, j);
+    size_t r = std::max(i, j);
+
+    return lce_lr(l, r);
+  }
+
+  // Return the number of common letters in text[i..] and text[j..].
+  // Here l must be smaller than r.
+  size_t lce_lr(size_t l, size_t r) const {
+    return lce_lr_up_to(l, r, m_size - r);
+  }
+
+  // Return {b, lce}, where lce is the number of common letters in text[i..]
+  // and text[j..] and b tells whether the lce ends with a mismatch.
+  std::pair<bool, size_t> lce_mismatch(size_t i, size_t j) const {
+    if (i == j) [[unlikely]] {
+      assert(i < m_size);
+      return {false, m_size - i};
+    }
+
+    size_t l = std::min(i, j);
+    size_t r = std::max(i, j);
+
+    size_t lce = lce_lr(l, r);
+    return {r + lce != m_size, lce};
+  }
+
+  // Return whether text[i..] is lexicographic smaller than text[j..]. Here i
+  // and j must be different.
+  bool is_leq_suffix(size_t i, size_t j) const {
+    assert(i != j);
+    size_t lce_val = lce_uneq(i, j);
+    return i + lce_val == m_size ||
+           ((j + lce_val != m_size) &&
+            m_text[i + lce_val] < m_text[j + lce_val]);
+  }
+
+  // Return the comparison of text[i..] and text[j..], see suffix_comparison.
+  suffix_comparison<char_type> compare_suffixes(size_t i, size_t j) const {
+    size_t lce_val = lce(i, j);
+    return make_suffix_comparison(m_text, m_size, i, j, lce_val);
+  }
+
+  // Return the lce of text[i..i+lce) and text[j..j+lce]
+  size_t lce_up_to(size_t i, size_t j, size_t up_to) const {
+    if (i == j) [[unlikely]] {
+      assert(i < m_size);
+      return m_size - i;
+    }
+
+    size_t l = std::min(i, j);
+    size_t r = std::max(i, j);
+    return lce_lr_up_to(l, r, std::min(m_size - r, up_to));
+  }
+
+  // Prefetch the text read by the naive scan of lce_lr(l, r).
+  void prefetch(size_t l, size_t r) const {
+    __builtin_prefetch(m_text + l);
+    __builtin_prefetch(m_text + r);
+  }
+
+  // Store the number of common letters in text[i..] and text[j..] in out[k]
+  // for each query (i, j) = queries[k]. Groups of queries are answered stage
+  // by stage, so the cache misses of one group overlap.
+  void lce_batch(std::span<const std::pair<size_t, size_t>> queries,
+                 std::span<size_t> out) const {
+    assert(out.size() >= queries.size());
+    std::array<pending_query, m_batch_group_size> pending;
+
+    for (size_t begin = 0; begin < queries.size();
+         begin += m_batch_group_size) {
+      size_t const end = std::min(begin + m_batch_group_size, queries.size());
+      // Stage 1: Prefetch the text read by the naive scan.
+      for (size_t k = begin; k < end; ++k) {
+        auto const [i, j] = queries[k];
+        prefetch(std::min(i, j), std::max(i, j));
+      }
+      // Stage 2: Scan the first t_naive_scan characters. For the remaining
+      // queries prefetch what the first exponential step reads.
+      size_t num_pending = 0;
+      for (size_t k = begin; k < end; ++k) {
+        auto const [i, j] = queries[k];
+        if (i == j) [[unlikely]] {
+          assert(i < m_size);
+          out[k] = m_size - i;
+          continue;
+        }
+        pending_query& q = pending[num_pending];
+        q.k = k;
+        q.l = std::min(i, j);
+        q.r = std::max(i, j);
+        out[k] = lce_scan(q.l, q.r, std::min(t_naive_scan, m_size - q.r));
+        if (out[k] == t_naive_scan) {
+          prefetch_fp_to(q.l);
+          prefetch_fp_to(q.r);
+          if (2 * t_naive_scan <= m_size - q.r) {
+            prefetch_fp_to(q.l + 2 * t_naive_scan);
+            prefetch_fp_to(q.r + 2 * t_naive_scan);
+          }
+          ++num_pending;
+        }
+      }
+      // Stage 3: Answer the remaining queries.
+      for (size_t p = 0; p < num_pending; ++p) {
+        pending_query const& q = pending[p];
+        out[q.k] = lce_exponential_search(q.l, q.r, m_size - q.r);
+      }
+    }
+  }
+
+  // Return the lce of text[i..] and text[j..], but at most max_lce. Both
+  // text[i..i+max_lce) and text[j..j+max_lce) must lie within the text.
+  uint64_t lce_scan(const uint64_t i, const uint64_t j,
+                    uint64_t max_lce) const {
+    uint64_t lce = 0;
+    // Compare blockwise.
+    while (lce + 8 <= max_lce) {
+      uint64_t const block_i = load_block(m_text + i + lce);
+      uint64_t const block_j = load_block(m_text + j + lce);
+      if (block_i != block_j) {
+        return lce + std::countl_zero(block_i ^ block_j) / 8;
+      }
+      lce += 8;
+    }
+    // Compare the stub character-wise.
+    while (lce < max_lce && m_text[i + lce] == m_text[j + lce]) {
+      ++lce;
+    }
+    return lce;
+  }
+
+ protected:
+  static constexpr uint64_t m_prime{(uint64_t{1} << 61) - 1};
+  static constexpr size_t m_batch_group_size = 16;
+
+  // A query of lce_batch, whose lce exceeds the first t_naive_scan characters.
+  struct pending_query {
+    size_t k, l, r;
+  };
+
+  lce_fp_mersenne_base() : m_text(nullptr), m_size(0) {
+  }
+
+  lce_fp_mersenne_base(char_type const* text, size_t size)
+      : m_text(text), m_size(size) {
+    static_assert(sizeof(t_char_type) == 1);
+    fill_power_tables(random_base());
+  }
+
+  lce_fp_mersenne_base(const lce_fp_mersenne_base& other) = delete;
+  lce_fp_mersenne_base& operator=(const lce_fp_mersenne_base& other) = delete;
+
+  lce_fp_mersenne_base(lce_fp_mersenne_base&& other) noexcept {
+    *this = std::move(other);
+  }
+
+  lce_fp_mersenne_base& operator=(lce_fp_mersenne_base&& other) noexcept {
+    m_text = std::exchange(other.m_text, nullptr);
+    m_size = std::exchange(other.m_size, 0);
+    m_char_powers = other.m_char_powers;
+    m_block_power = other.m_block_power;
+    m_exp_powers = other.m_exp_powers;
+    return *this;
+  }
+
+  // Return the fingerprint of the text up to a block, when the fingerprint of
+  // the text up to the previous block is fingerprint.
+  uint64_t append_block(uint64_t fingerprint, uint64_t block) const {
+    return mersenne::add_mod<uint64_t, m_prime>(
+        mersenne::mult_mod<uint64_t, m_prime>(fingerprint, m_block_power),
+        block_fp(block));
+  }
+
+  // Return the fingerprint of the 8 characters of a block. The products of the
+  // characters and the powers of the base are summed up before a single
+  // reduction.
+  uint64_t block_fp(uint64_t const block) const {
+    __extension__ typedef unsigned __int128 uint128_t;
+    uint128_t sum = 0;
+    for (size_t k = 0; k < 8; ++k) {
+      sum += uint128_t{(block >> (8 * k)) & 0xff} * m_char_powers[k];
+    }
+    return static_cast<uint64_t>(mersenne::mod<uint128_t, m_prime>(sum));
+  }
+
+  // Return the i'th block. A block contains 8 character. The last block is
+  // padded with zeros.
+  uint64_t get_block(const uint64_t i) const {
+    if (8 * i + 8 <= m_size) [[likely]] {
+      return load_block(m_text + 8 * i);
+    }
+    std::array<char_type, 8> padded{};
+    std::memcpy(padded.data(), m_text + 8 * i, m_size - 8 * i);
+    return load_block(padded.data());
+  }
+
+  char_type const* m_text;
+  size_t m_size;
+
+  // base^k for k <= 8.
+  std::array<uint64_t, 9> m_char_powers{};
+  // base^8, the factor of appending a block.
+  uint64_t m_block_power = 0;
+  // base^(2^exp).
+  std::array<uint64_t, 64> m_exp_powers{};
+
+ private:
+  t_derived const& derived() const {
+    return static_cast<t_derived const&>(*this);
+  }
+
+  static uint64_t random_base() {
+    static std::mt19937_64 g = std::mt19937_64(std::random_device()());
+    return std::uniform_int_distribution<uint64_t>(2, m_prime - 2)(g);
+  }
+
+  void fill_power_tables(uint64_t const base) {
+    m_char_powers[0] = 1;
+    for (size_t k = 1; k < m_char_powers.size(); ++k) {
+      m_char_powers[k] =
+          mersenne::mult_mod<uint64_t, m_prime>(m_char_powers[k - 1], base);
+    }
+    m_block_power = m_char_powers[8];
+    m_exp_powers[0] = base;
+    for (size_t exp = 1; exp < m_exp_powers.size(); ++exp) {
+      m_exp_powers[exp] = mersenne::mult_mod<uint64_t, m_prime>(
+          m_exp_powers[exp - 1], m_exp_powers[exp - 1]);
+    }
+  }
+
+  // Return the 8 characters starting at pos as big endian integer.
+  static uint64_t load_block(char_type const* pos) {
+    uint64_t block;
+    std::memcpy(&block, pos, sizeof(uint64_t));
+    if constexpr (std::endian::native == std::endian::little) {
+      block = __builtin_bswap64(block);
+    }
+    return block;
+  }
+
+  // Return the fingerprint of T[0, i].
+  uint64_t fp_to(size_t i) const {
+    size_t const chars = (i + 1) & 7;
+    uint64_t const prev_fingerprint = derived().fp_blocks((i + 1) / 8);
+    if (chars == 0) {
+      return prev_fingerprint;
+    }
+    return mersenne::add_mod<uint64_t, m_prime>(
+        mersenne::mult_mod<uint64_t, m_prime>(prev_fingerprint,
+                                              m_char_powers[chars]),
+        block_fp(get_block(i / 8) >> (64 - 8 * chars)));
+  }
+
+  // Calculate the fingerprint of T[from, from + 2^exp).
+  uint64_t fp_exp(const uint64_t from, const int exp) const {
+    return fp_exp((from != 0) ? fp_to(from - 1) : 0, from, exp);
+  }
+
+  // Calculates the fingerprint of T[from, from + 2^exp) when the fingerprint of
+  // T[0, from) is already known.
+  uint64_t fp_exp(uint64_t fingerprint_to_i, const uint64_t from,
+                  const int exp) const {
+    uint64_t const fingerprint_to_j = fp_to(from + (size_t{1} << exp) - 1);
+    return mersenne::sub_mod<uint64_t, m_prime>(
+        fingerprint_to_j, mersenne::mult_mod<uint64_t, m_prime>(
+                              fingerprint_to_i, m_exp_powers[exp]));
+  }
+
+  // Prefetch the fingerprint of T[0, pos) read by fp_to(pos - 1).
+  void prefetch_fp_to(size_t pos) const {
+    if (pos != 0) {
+      derived().prefetch_fp_blocks(pos / 8);
+      __builtin_prefetch(m_text + pos - 1);
+    }
+  }
+
+  // Return the lce of text[l..] and text[r..], but at most max_lce.
+  size_t lce_lr_up_to(size_t l, size_t r, uint64_t max_lce) const {
+    uint64_t lce = lce_scan(l, r, std::min(t_naive_scan, max_lce));
+    if (lce < t_naive_scan) {
+      return lce;
+    }
+    return lce_exponential_search(l, r, max_lce);
+  }
+
+  // Return the lce of text[l..] and text[r..], but at most max_lce, when the
+  // first t_naive_scan characters are known to match.
+  size_t lce_exponential_search(size_t l, size_t r, uint64_t max_lce) const {
+    uint64_t dist = t_naive_scan * 2;
+    int exp = std::countr_zero(dist);
+
+    const uint64_t fingerprint_to_l = (l != 0) ? fp_to(l - 1) : 0;
+    const uint64_t fingerprint_to_r = (r != 0) ? fp_to(r - 1) : 0;
+
+    while (dist <= max_lce && fp_exp(fingerprint_to_l, l, exp) ==
+                                  fp_exp(fingerprint_to_r, r, exp)) {
+      ++exp;
+      dist *= 2;
+    }
+
+    // Binary search. We start it at i2 and j2, because we know that up until
+    // i2 and j2 everything matched.
+    --exp;
+    dist /= 2;
+    uint64_t add = dist;
+
+    while (dist > t_naive_scan) {
+      --exp;
+      dist /= 2;
+      if (add + dist <= max_lce &&
+          fp_exp(l + add, exp) == fp_exp(r + add, exp)) {
+        add += dist;
+      }
+    }
+    max_lce -= add;
+    return add + lce_scan(l + add, r + add, max_lce);
+  }
+};
+}  // namespace alx::lce
@@ -0,0 +1,134 @@
+/*******************************************************************************
+ * alx/lce/lce_fp_sampled.hpp
+ *
+ * Copyright (C) 2022 Alexander Herlez <alexander.herlez@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#include <assert.h>
+#include <omp.h>
+
+#include <cstdint>
+#include <memory>
+
+#include "lce/lce_fp_mersenne_base.hpp"
+
+namespace alx::lce {
+
+// Fingerprinting LCE data structure that keeps the text as it is and stores
+// the prefix fingerprint (modulo the mersenne prime 2^61-1) only of every
+// t_sample_rate'th block of 8 characters. This needs 8/t_sample_rate bits per
+// character on top of the text. The queries and the fingerprints are shared
+// with lce_fp_mersenne, see lce_fp_mersenne_base.
+//
+// The naive scan reads the plain text. A fingerprint between two samples is
+// recomputed from the closest sample: forwards by appending blocks, or
+// backwards by removing them, so at most t_sample_rate/2 blocks are read.
+template <typename t_char_type = uint8_t, size_t t_naive_scan = 32,
+          size_t t_sample_rate = 16>
+class lce_fp_sampled
+    : public lce_fp_mersenne_base<
+          lce_fp_sampled<t_char_type, t_naive_scan, t_sample_rate>,
+          t_char_type, t_naive_scan> {
+  static_assert(t_sample_rate > 0);
+  typedef lce_fp_mersenne_base<lce_fp_sampled, t_char_type, t_naive_scan>
+      base_type;
+  friend base_type;
+
+ public:
+  typedef t_char_type char_type;
+
+  lce_fp_sampled() {
+  }
+
+  lce_fp_sampled(char_type const* text, size_t size) : base_type(text, size) {
+    size_t const num_full_blocks = size / 8;
+    size_t const num_samples = num_full_blocks / t_sample_rate + 1;
+    m_sample_fps = std::make_unique_for_overwrite<uint64_t[]>(num_samples);
+    // By Fermat's little theorem, a^(p-2) is the inverse of a.
+    m_block_inverse = mersenne::pow_mod<uint64_t, m_prime>(
+        this->m_block_power, m_prime - 2);
+    m_group_power = mersenne::pow_mod<uint64_t, m_prime>(this->m_block_power,
+                                                         t_sample_rate);
+
+    // Fingerprints of the groups of t_sample_rate blocks between two samples.
+    m_sample_fps[0] = 0;
+#pragma omp parallel for
+    for (size_t s = 1; s < num_samples; ++s) {
+      uint64_t fingerprint = 0;
+      for (size_t b = (s - 1) * t_sample_rate; b < s * t_sample_rate; ++b) {
+        fingerprint = this->append_block(fingerprint, this->get_block(b));
+      }
+      m_sample_fps[s] = fingerprint;
+    }
+
+    // Prefix sum over fingerprints of groups.
+    for (size_t s = 1; s < num_samples; ++s) {
+      m_sample_fps[s] = mersenne::add_mod<uint64_t, m_prime>(
+          mersenne::mult_mod<uint64_t, m_prime>(m_sample_fps[s - 1],
+                                                m_group_power),
+          m_sample_fps[s]);
+    }
+  }
+
+  template <typename C>
+  lce_fp_sampled(C const& container)
+      : lce_fp_sampled(container.data(), container.size()) {
+  }
+
+  // Return the number of bytes used in addition to the text.
+  size_t size_in_bytes() const {
+    return (this->m_size / 8 / t_sample_rate + 1) * sizeof(uint64_t);
+  }
+
+ private:
+  using base_type::m_prime;
+
+  // m_sample_fps[s] is the fingerprint of the first s*t_sample_rate blocks.
+  std::unique_ptr<uint64_t[]> m_sample_fps;
+  // The inverse of base^8, the factor of removing a block.
+  uint64_t m_block_inverse = 0;
+  // base^(8*t_sample_rate), the factor of appending a group of blocks.
+  uint64_t m_group_power = 0;
+
+  // Inverse of append_block.
+  uint64_t remove_block(uint64_t fingerprint, uint64_t block) const {
+    return mersenne::mult_mod<uint64_t, m_prime>(
+        mersenne::sub_mod<uint64_t, m_prime>(fingerprint,
+                                             this->block_fp(block)),
+        m_block_inverse);
+  }
+
+  // Return the fingerprint of the first b blocks.
+  uint64_t fp_blocks(size_t b) const {
+    size_t s = b / t_sample_rate;
+    size_t const offset = b % t_sample_rate;
+    if (offset > t_sample_rate / 2 &&
+        (s + 1) * t_sample_rate <= this->m_size / 8) {
+      // The next sample is closer.
+      uint64_t fingerprint = m_sample_fps[s + 1];
+      for (size_t i = (s + 1) * t_sample_rate; i > b; --i) {
+        fingerprint = remove_block(fingerprint, this->get_block(i - 1));
+      }
+      return fingerprint;
+    }
+    uint64_t fingerprint = m_sample_fps[s];
+    for (size_t i = s * t_sample_rate; i < b; ++i) {
+      fingerprint = this->append_block(fingerprint, this->get_block(i));
+    }
+    return fingerprint;
+  }
+
+  // Prefetch the samples that fp_blocks(b) may read. The blocks between them
+  // are close to the text of the query.
+  void prefetch_fp_blocks(size_t b) const {
+    size_t const s = b / t_sample_rate;
+    __builtin_prefetch(&m_sample_fps[s]);
+    if ((s + 1) * t_sample_rate <= this->m_size / 8) {
+      __builtin_prefetch(&m_sample_fps[s + 1]);
+    }
+  }
+};
+}  // namespace alx::lce
@@ -9,9 +9,12 @@
 #pragma once
 #include <assert.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 
+#include "lce/suffix_comparison.hpp"
+
 namespace alx::lce {
 
 class lce_memcmp {
@@ -35,6 +38,11 @@ class lce_memcmp {
     return is_leq_suffix(m_text, m_size, i, j);
   }
 
+  // Return the comparison of text[i..] and text[j..], see suffix_comparison.
+  suffix_comparison<char_type> compare_suffixes(size_t i, size_t j) const {
+    return compare_suffixes(m_text, m_size, i, j);
+  }
+
   // Return whether text[i..] is lexicographic smaller than text[j..]. Here i
   // and j must be different.
   static bool is_leq_suffix(char_type const* text, size_t size, size_t i,
@@ -46,6 +54,18 @@ class lce_memcmp {
     return (result < 0) || (result == 0 && (i > j));
   }
 
+  // Return the comparison of text[i..] and text[j..], see suffix_comparison.
+  static suffix_comparison<char_type> compare_suffixes(char_type const* text,
+                                                       size_t size, size_t i,
+                                                       size_t j) {
+    size_t r = std::max(i, j);
+    size_t max_lce = (size - r);
+    size_t lce_val =
+        std::mismatch(text + i, text + i + max_lce, text + j).first -
+        (text + i);
+    return make_suffix_comparison(text, size, i, j, lce_val);
+  }
+
  private:
   char_type const* m_text;
   size_t m_size;
@@ -0,0 +1,314 @@
+/*******************************************************************************
+ * alx/lce/lce_naive_simd.hpp
+ *
+ * Copyright (C) 2022 Alexander Herlez <alexander.herlez@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#include <assert.h>
+#include <immintrin.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "lce/suffix_comparison.hpp"
+
+namespace alx::lce {
+
+// Naive LCE scan on explicit 16/32/64-byte compare+movemask kernels. The
+// kernel is selected once at runtime (SSE4.2, AVX2 or AVX-512BW), so the scan
+// does not depend on the instruction set the binary was compiled for.
+template <typename t_char_type = uint8_t>
+class lce_naive_simd {
+ public:
+  typedef t_char_type char_type;
+  typedef size_t (*kernel_type)(uint8_t const*, uint8_t const*, size_t);
+
+  lce_naive_simd() : m_text(nullptr), m_size(0) {
+  }
+
+  lce_naive_simd(char_type const* text, size_t size)
+      : m_text(text), m_size(size) {
+  }
+
+  template <typename C>
+  lce_naive_simd(C const& container)
+      : lce_naive_simd(container.data(), container.size()) {
+  }
+
+  // Return the number of common letters in text[i..] and text[j..].
+  size_t lce(size_t i, size_t j) const {
+    return lce(m_text, m_size, i, j);
+  }
+
+  // Return the number of common letters in text[i..] and text[j..]. Here i and
+  // j must be different.
+  size_t lce_uneq(size_t i, size_t j) const {
+    return lce_uneq(m_text, m_size, i, j);
+  }
+
+  // Return the number of common letters in text[i..] and text[j..].
+  // Here l must be smaller than r.
+  size_t lce_lr(size_t l, size_t r) const {
+    return lce_lr(m_text, m_size, l, r);
+  }
+
+  // Return {b, lce}, where lce is the number of common letters in text[i..]
+  // and text[j..] and b tells whether the lce ends with a mismatch.
+  std::pair<bool, size_t> lce_mismatch(size_t i, size_t j) const {
+    return lce_mismatch(m_text, m_size, i, j);
+  }
+
+  // Return whether text[i..] is lexicographic smaller than text[j..]. Here i
+  // and j must be different.
+  bool is_leq_suffix(size_t i, size_t j) const {
+    return is_leq_suffix(m_text, m_size, i, j);
+  }
+
+  // Return the comparison of text[i..] and text[j..], see suffix_comparison.
+  suffix_comparison<char_type> compare_suffixes(size_t i, size_t j) const {
+    return compare_suffixes(m_text, m_size, i, j);
+  }
+
+  // Return the lce of text[i..i+lce) and text[j..j+lce]
+  size_t lce_up_to(size_t i, size_t j, size_t up_to) const {
+    return lce_up_to(m_text, m_size, i, j, up_to);
+  }
+
+  // Return the number of common letters in text[i..] and text[j..].
+  static size_t lce(char_type const* text, size_t size, size_t i, size_t j) {
+    if (i == j) [[unlikely]] {
+      assert(i < size);
+      return size - i;
+    }
+    return lce_uneq(text, size, i, j);
+  }
+
+  // Return the number of common letters in text[i..] and text[j..].
+  static size_t lce_uneq(char_type const* text, size_t size, size_t i,
+                         size_t j) {
+    assert(i != j);
+
+    size_t l = std::min(i, j);
+    size_t r = std::max(i, j);
+
+    return lce_lr(text, size, l, r);
+  }
+
+  // Return the number of common letters in text[i..] and text[j..].
+  // Here l must be smaller than r.
+  static size_t lce_lr(char_type const* text, size_t size, size_t l, size_t r) {
+    assert(l < r);
+    uint8_t const* const bytes_l = reinterpret_cast<uint8_t const*>(text + l);
+    uint8_t const* const bytes_r = reinterpret_cast<uint8_t const*>(text + r);
+    return kernel()(bytes_l, bytes_r, (size - r) * sizeof(char_type)) /
+           sizeof(char_type);
+  }
+
+  // Return {b, lce}, where lce is the number of common letters in text[i..]
+  // and text[j..] and b tells whether the lce ends with a mismatch.
+  static std::pair<bool, size_t> lce_mismatch(char_type const* text,
+                                              size_t size, size_t i, size_t j) {
+    if (i == j) [[unlikely]] {
+      assert(i < size);
+      return {false, size - i};
+    }
+
+    size_t l = std::min(i, j);
+    size_t r = std::max(i, j);
+
+    size_t lce = lce_lr(text, size, l, r);
+    return {r + lce != size, lce};
+  }
+
+  // Return whether text[i..] is lexicographic smaller than text[j..]. Here i
+  // and j must be different.
+  static bool is_leq_suffix(char_type const* text, size_t size, size_t i,
+                            size_t j) {
+    assert(i != j);
+    size_t lce_val = lce_uneq(text, size, i, j);
+    return (i + lce_val == size ||
+            ((j + lce_val != size) && text[i + lce_val] < text[j + lce_val]));
+  }
+
+  // Return the comparison of text[i..] and text[j..], see suffix_comparison.
+  static suffix_comparison<char_type> compare_suffixes(char_type const* text,
+                                                       size_t size, size_t i,
+                                                       size_t j) {
+    size_t lce_val = lce(text, size, i, j);
+    return make_suffix_comparison(text, size, i, j, lce_val);
+  }
+
+  // Return the lce of text[i..i+lce) and text[j..j+lce]
+  static size_t lce_up_to(char_type const* text, size_t size, size_t i,
+                          size_t j, size_t up_to) {
+    if (i == j) [[unlikely]] {
+      assert(i < size);
+      return size - i;
+    }
+
+    size_t l = std::min(i, j);
+    size_t r = std::max(i, j);
+
+    size_t lce_max = std::min(r + up_to, size) - r;
+    return lce_lr(text, r + lce_max, l, r);
+  }
+
+  // Return the kernel that is used on this machine.
+  static kernel_type kernel() {
+    static kernel_type const selected = select_kernel();
+    return selected;
+  }
+
+  // Return the name of the kernel that is used on this machine.
+  static char const* kernel_name() {
+    kernel_type const k = kernel();
+    if (k == &lce_bytes_avx512) {
+      return "avx512bw";
+    } else if (k == &lce_bytes_avx2) {
+      return "avx2";
+    } else if (k == &lce_bytes_sse42) {
+      return "sse4.2";
+    }
+    return "scalar";
+  }
+
+  // Return the number of common bytes of a[0..max_lce) and b[0..max_lce).
+  static size_t lce_bytes_scalar(uint8_t const* a, uint8_t const* b,
+                                 size_t max_lce) {
+    size_t lce = 0;
+    while (lce + sizeof(uint64_t) <= max_lce) {
+      uint64_t word_a;
+      uint64_t word_b;
+      std::memcpy(&word_a, a + lce, sizeof(uint64_t));
+      std::memcpy(&word_b, b + lce, sizeof(uint64_t));
+      if (word_a != word_b) {
+        return lce + std::countr_zero(word_a ^ word_b) / 8;
+      }
+      lce += sizeof(uint64_t);
+    }
+    while (lce < max_lce && a[lce] == b[lce]) {
+      ++lce;
+    }
+    return lce;
+  }
+
+  // Return the number of common bytes of a[0..max_lce) and b[0..max_lce).
+  __attribute__((target("sse4.2"))) static size_t lce_bytes_sse42(
+      uint8_t const* a, uint8_t const* b, size_t max_lce) {
+    if (max_lce < 16) {
+      return lce_bytes_scalar(a, b, max_lce);
+    }
+    return lce_bytes_vectorized<16, &mismatch_mask_sse42<false>,
+                                &mismatch_mask_sse42<true>>(a, b, max_lce);
+  }
+
+  // Return the number of common bytes of a[0..max_lce) and b[0..max_lce).
+  __attribute__((target("avx2"))) static size_t lce_bytes_avx2(
+      uint8_t const* a, uint8_t const* b, size_t max_lce) {
+    if (max_lce < 32) {
+      return lce_bytes_sse42(a, b, max_lce);
+    }
+    return lce_bytes_vectorized<32, &mismatch_mask_avx2<false>,
+                                &mismatch_mask_avx2<true>>(a, b, max_lce);
+  }
+
+  // Return the number of common bytes of a[0..max_lce) and b[0..max_lce).
+  __attribute__((target("avx512f,avx512bw,bmi2"))) static size_t
+  lce_bytes_avx512(uint8_t const* a, uint8_t const* b, size_t max_lce) {
+    if (max_lce < 64) {
+      // Masked loads do not touch bytes beyond max_lce.
+      __mmask64 const valid = _bzhi_u64(~uint64_t{0}, max_lce);
+      __m512i const va = _mm512_maskz_loadu_epi8(valid, a);
+      __m512i const vb = _mm512_maskz_loadu_epi8(valid, b);
+      uint64_t const m = _mm512_cmpneq_epi8_mask(va, vb);
+      return m != 0 ? std::countr_zero(m) : max_lce;
+    }
+    return lce_bytes_vectorized<64, &mismatch_mask_avx512<false>,
+                                &mismatch_mask_avx512<true>>(a, b, max_lce);
+  }
+
+ private:
+  typedef uint64_t (*mask_function_type)(uint8_t const*, uint8_t const*);
+
+  // Return a bit mask of the mismatching bytes in a[0..16) and b[0..16).
+  template <bool b_aligned>
+  __attribute__((target("sse4.2"))) static uint64_t mismatch_mask_sse42(
+      uint8_t const* a, uint8_t const* b) {
+    __m128i const va = _mm_loadu_si128(reinterpret_cast<__m128i const*>(a));
+    __m128i const vb =
+        b_aligned ? _mm_load_si128(reinterpret_cast<__m128i const*>(b))
+                  : _mm_loadu_si128(reinterpret_cast<__m128i const*>(b));
+    return ~static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb))) &
+           0xFFFF;
+  }
+
+  // Return a bit mask of the mismatching bytes in a[0..32) and b[0..32).
+  template <bool b_aligned>
+  __attribute__((target("avx2"))) static uint64_t mismatch_mask_avx2(
+      uint8_t const* a, uint8_t const* b) {
+    __m256i const va = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(a));
+    __m256i const vb =
+        b_aligned ? _mm256_load_si256(reinterpret_cast<__m256i const*>(b))
+                  : _mm256_loadu_si256(reinterpret_cast<__m256i const*>(b));
+    return ~static_cast<uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb)));
+  }
+
+  // Return a bit mask of the mismatching bytes in a[0..64) and b[0..64).
+  template <bool b_aligned>
+  __attribute__((target("avx512f,avx512bw"))) static uint64_t
+  mismatch_mask_avx512(uint8_t const* a, uint8_t const* b) {
+    __m512i const va = _mm512_loadu_si512(a);
+    __m512i const vb = b_aligned ? _mm512_load_si512(b) : _mm512_loadu_si512(b);
+    return _mm512_cmpneq_epi8_mask(va, vb);
+  }
+
+  // Return the number of common bytes of a[0..max_lce) and b[0..max_lce),
+  // where max_lce >= width. After an unaligned head, the main loop loads b
+  // aligned to width. The tail is an overlapping unaligned block that ends at
+  // max_lce, so no byte beyond max_lce is read.
+  template <size_t width, mask_function_type mismatch_mask_unaligned,
+            mask_function_type mismatch_mask_aligned>
+  __attribute__((always_inline)) static size_t lce_bytes_vectorized(
+      uint8_t const* a, uint8_t const* b, size_t max_lce) {
+    assert(max_lce >= width);
+    if (uint64_t const m = mismatch_mask_unaligned(a, b); m != 0) {
+      return std::countr_zero(m);
+    }
+    size_t lce = width - (reinterpret_cast<uintptr_t>(b) & (width - 1));
+    for (; lce + width <= max_lce; lce += width) {
+      if (uint64_t const m = mismatch_mask_aligned(a + lce, b + lce); m != 0) {
+        return lce + std::countr_zero(m);
+      }
+    }
+    size_t const last = max_lce - width;
+    if (uint64_t const m = mismatch_mask_unaligned(a + last, b + last);
+        m != 0) {
+      return last + std::countr_zero(m);
+    }
+    return max_lce;
+  }
+
+  static kernel_type select_kernel() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("bmi2")) {
+      return &lce_bytes_avx512;
+    } else if (__builtin_cpu_supports("avx2")) {
+      return &lce_bytes_avx2;
+    } else if (__builtin_cpu_supports("sse4.2")) {
+      return &lce_bytes_sse42;
+    }
+    return &lce_bytes_scalar;
+  }
+
+  char_type const* m_text;
+  size_t m_size;
+};
+}  // namespace alx::lce
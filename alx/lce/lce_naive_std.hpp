@@ -11,6 +11,8 @@
 
 #include <cstdint>
 
+#include "lce/suffix_comparison.hpp"
+
 namespace alx::lce {
 
 template <typename t_char_type = uint8_t>
@@ -59,6 +61,11 @@ class lce_naive_std {
     return is_leq_suffix(m_text, m_size, i, j);
   }
 
+  // Return the comparison of text[i..] and text[j..], see suffix_comparison.
+  suffix_comparison<char_type> compare_suffixes(size_t i, size_t j) const {
+    return compare_suffixes(m_text, m_size, i, j);
+  }
+
   // Return the lce of text[i..i+lce) and text[j..j+lce]
   size_t lce_up_to(size_t i, size_t j, size_t up_to) const {
     return lce_up_to(m_text, m_size, i, j, up_to);
@@ -121,6 +128,14 @@ class lce_naive_std {
             ((j + lce_val != size) && text[i + lce_val] < text[j + lce_val]));
   }
 
+  // Return the comparison of text[i..] and text[j..], see suffix_comparison.
+  static suffix_comparison<char_type> compare_suffixes(char_type const* text,
+                                                       size_t size, size_t i,
+                                                       size_t j) {
+    size_t lce_val = lce(text, size, i, j);
+    return make_suffix_comparison(text, size, i, j, lce_val);
+  }
+
   // Return the lce of text[i..i+lce) and text[j..j+lce]
   static size_t lce_up_to(char_type const* text, size_t size, size_t i,
                           size_t j, size_t up_to) {
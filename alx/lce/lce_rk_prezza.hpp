@@ -48,6 +48,8 @@
 #include <includes.hpp>
 #include <rk_lce_bin.hpp>
 
+#include "lce/suffix_comparison.hpp"
+
 namespace rklce {
 
 class lce_rk_prezza {
@@ -208,6 +210,19 @@ class lce_rk_prezza {
     };
   }
 
+  /*
+   * lexicographic order of the i-th and j-th suffixes together with their LCE
+   * and the characters following it
+   *
+   * Time: O(log n)
+   *
+   */
+  inline alx::lce::suffix_comparison<char_type> compare_suffixes(uint64_t i,
+                                                                 uint64_t j) {
+    uint64_t v_lce = (i == j) ? n_ - i : lce(i, j);
+    return alx::lce::make_suffix_comparison<char_type>(text_, n_, i, j, v_lce);
+  }
+
   inline int isSmallerSuffix([[maybe_unused]] const uint64_t i,
                              [[maybe_unused]] const uint64_t j) {
     return true;
@@ -8,13 +8,16 @@
 
 #pragma once
 
+#include <array>
 #include <chrono>
 #include <cmath>
 #include <memory>
+#include <span>
 #include <vector>
 
 #include "lce/lce_classic_for_sss.hpp"
-#include "lce/lce_naive_wordwise.hpp"
+#include "lce/lce_naive_simd.hpp"
+#include "lce/suffix_comparison.hpp"
 #include "pred/pred_index.hpp"
 #include "rolling_hash/reduce_fingerprints.hpp"
 #include "rolling_hash/string_synchronizing_set.hpp"
@@ -32,7 +35,8 @@
 namespace alx::lce {
 
 template <typename t_char_type = uint8_t, uint64_t t_tau = 1024,
-          typename t_index_type = uint32_t, bool t_prefer_long = false>
+          typename t_index_type = uint32_t, bool t_prefer_long = false,
+          typename t_construction = alx::suffix_sort::gsaca_backend>
 class lce_sss {
  public:
   typedef t_char_type char_type;
@@ -107,7 +111,8 @@ class lce_sss {
 #endif
 #endif
 
-    m_fp_lce = alx::lce::lce_classic_for_sss<t_index_type, t_tau>(
+    m_fp_lce = alx::lce::lce_classic_for_sss<t_index_type, t_tau,
+                                             t_construction>(
         reinterpret_cast<uint8_t const*>(m_text), m_size, reduced_fps.data(),
         reduced_fps.size(), sss);
 
@@ -148,16 +153,172 @@ class lce_sss {
   // Return the number of common letters in text[i..] and text[j..].
   // Here l must be smaller than r.
   inline uint64_t lce_lr(size_t l, size_t r) const {
+    size_t lce_local, l_, r_;
+    // Case 0: Mismatch at first 3*tau symbols
+    if (lce_scan_local(l, r, lce_local, l_, r_)) {
+      return lce_local;
+    }
+    return lce_synchronized(l, r, l_, r_);
+  }
+
+  // Store the number of common letters in text[i..] and text[j..] in out[k]
+  // for each query (i, j) = queries[k]. Groups of queries are answered stage
+  // by stage, so the cache misses of one group overlap.
+  void lce_batch(std::span<const std::pair<size_t, size_t>> queries,
+                 std::span<size_t> out) const {
+    assert(out.size() >= queries.size());
+    std::array<pending_query, m_batch_group_size> pending;
+
+    for (size_t begin = 0; begin < queries.size();
+         begin += m_batch_group_size) {
+      size_t const end = std::min(begin + m_batch_group_size, queries.size());
+      // Stage 1: Prefetch the text at both positions.
+      for (size_t k = begin; k < end; ++k) {
+        __builtin_prefetch(m_text + queries[k].first);
+        __builtin_prefetch(m_text + queries[k].second);
+      }
+      // Stage 2: Scan the first 3*tau symbols. For the remaining queries
+      // prefetch what is read after the synchronizing positions.
+      size_t num_pending = 0;
+      for (size_t k = begin; k < end; ++k) {
+        auto const [i, j] = queries[k];
+        if (i == j) [[unlikely]] {
+          assert(i < m_size);
+          out[k] = m_size - i;
+          continue;
+        }
+        pending_query& q = pending[num_pending];
+        q.k = k;
+        q.l = std::min(i, j);
+        q.r = std::max(i, j);
+        if (!lce_scan_local(q.l, q.r, out[k], q.l_, q.r_)) {
+          m_fp_lce.prefetch(q.l_, q.r_);
+          ++num_pending;
+        }
+      }
+      // Stage 3: Answer the remaining queries.
+      for (size_t p = 0; p < num_pending; ++p) {
+        pending_query const& q = pending[p];
+        out[q.k] = lce_synchronized(q.l, q.r, q.l_, q.r_);
+      }
+    }
+  }
+
+  // Return {b, lce}, where lce is the number of common letters in text[i..]
+  // and text[j..] and b tells whether the lce ends with a mismatch.
+  std::pair<bool, size_t> lce_mismatch(size_t i, size_t j) const {
+    if (i == j) [[unlikely]] {
+      assert(i < m_size);
+      return {false, m_size - i};
+    }
+
+    size_t l = std::min(i, j);
+    size_t r = std::max(i, j);
+
+    size_t lce = lce_lr(l, r);
+    return {r + lce != m_size, lce};
+  }
+
+  // Return whether text[i..] is lexicographic smaller than text[j..]. Here i
+  // and j must be different.
+  bool is_leq_suffix(size_t i, size_t j) const {
+    assert(i != j);
+    size_t lce_val = lce_uneq(i, j);
+    return (
+        i + lce_val == m_size ||
+        ((j + lce_val != m_size) && m_text[i + lce_val] < m_text[j + lce_val]));
+  }
+
+  // Return the comparison of text[i..] and text[j..], see suffix_comparison.
+  suffix_comparison<char_type> compare_suffixes(size_t i, size_t j) const {
+    size_t lce_val = lce(i, j);
+    return make_suffix_comparison(m_text, m_size, i, j, lce_val);
+  }
+
+  // Store the number of common letters in text[pivot..] and text[others[k]..]
+  // in out[k]. The successor of pivot in the synchronizing set is computed
+  // only once for all queries.
+  void lce_many(size_t pivot, std::span<const size_t> others,
+                std::span<size_t> out) const {
+    assert(out.size() >= others.size());
+    cached_successor const pivot_succ{pivot, m_pred.successor(pivot)};
+    for (size_t k = 0; k < others.size(); ++k) {
+      out[k] = lce_pivot(pivot_succ, others[k]);
+    }
+  }
+
+  // Store in out[k] whether text[others[k]..] is lexicographic smaller than
+  // text[pivot..]. Here others[k] must be different from pivot.
+  void is_leq_suffix_many(size_t pivot, std::span<const size_t> others,
+                          std::span<uint8_t> out) const {
+    assert(out.size() >= others.size());
+    cached_successor const pivot_succ{pivot, m_pred.successor(pivot)};
+    for (size_t k = 0; k < others.size(); ++k) {
+      size_t const i = others[k];
+      assert(i != pivot);
+      size_t const lce_val = lce_pivot(pivot_succ, i);
+      out[k] = i + lce_val == m_size ||
+               ((pivot + lce_val != m_size) &&
+                m_text[i + lce_val] < m_text[pivot + lce_val]);
+    }
+  }
+
+  char_type operator[](size_t i) const { return m_text[i]; }
+
+  size_t size() const { return m_size; }
+
+ private:
+  // A query of lce_batch, whose lce exceeds the first 3*tau symbols.
+  struct pending_query {
+    size_t k, l, r, l_, r_;
+  };
+  static constexpr size_t m_batch_group_size = 16;
+
+  // The successor of a text position in the synchronizing set.
+  struct cached_successor {
+    size_t pos;
+    pred::result succ;
+  };
+
+  // Return the successor of i in the synchronizing set. It is taken from cache
+  // if that belongs to i.
+  pred::result successor(size_t i, cached_successor const* cache) const {
+    if (cache != nullptr && cache->pos == i) {
+      return cache->succ;
+    }
+    return m_pred.successor(i);
+  }
+
+  // Return the number of common letters in text[pivot.pos..] and text[i..].
+  size_t lce_pivot(cached_successor const& pivot, size_t i) const {
+    if (i == pivot.pos) [[unlikely]] {
+      assert(i < m_size);
+      return m_size - i;
+    }
+    size_t const l = std::min(i, pivot.pos);
+    size_t const r = std::max(i, pivot.pos);
+    size_t lce_local, l_, r_;
+    if (lce_scan_local(l, r, lce_local, l_, r_, &pivot)) {
+      return lce_local;
+    }
+    return lce_synchronized(l, r, l_, r_);
+  }
+
+  // Compare the first 3*tau symbols of text[l..] and text[r..]. If the lce
+  // ends there, store it in lce and return true. Otherwise store the indexes of
+  // the succeeding synchronizing positions in l_ and r_ and return false. A
+  // known successor of l or r can be passed in cache.
+  bool lce_scan_local(size_t l, size_t r, size_t& lce, size_t& l_, size_t& r_,
+                      cached_successor const* cache = nullptr) const {
     std::vector<t_index_type> const& sss = m_sync_set.get_sss();
-    size_t l_, r_;
 
     if constexpr (t_prefer_long) {
       // Only scan until synchronizing position
       size_t lce_max{m_size - r};
       size_t lce_local_max{std::min(3 * t_tau, lce_max)};
 
-      pred::result l_res = m_pred.successor(l);
-      pred::result r_res = m_pred.successor(r);
+      pred::result l_res = successor(l, cache);
+      pred::result r_res = successor(r, cache);
       l_ = l_res.pos;
       r_ = r_res.pos;
       if (l_res.exists && r_res.exists && (sss[l_] - l == sss[r_] - r)) {
@@ -165,81 +326,61 @@ class lce_sss {
             std::min(lce_local_max, static_cast<size_t>(sss[l_] - l));
       }
 
-      size_t lce_local = alx::lce::lce_naive_wordwise<t_char_type>::lce_lr(
+      size_t lce_local = alx::lce::lce_naive_simd<t_char_type>::lce_lr(
           m_text, r + lce_local_max, l, r);
 
       // Case 0: Mismatch at first 3*tau symbols
       if (lce_local < lce_local_max || lce_local == lce_max) {
-        return lce_local;
+        lce = lce_local;
+        return true;
       }
     } else {
       // Naive part until synchronizing position
       size_t lce_max{m_size - r};
       size_t lce_local_max{std::min(3 * t_tau, lce_max)};
-      size_t lce_local = alx::lce::lce_naive_wordwise<t_char_type>::lce_lr(
+      size_t lce_local = alx::lce::lce_naive_simd<t_char_type>::lce_lr(
           m_text, r + lce_local_max, l, r);
 
       // Case 0: Mismatch at first 3*tau symbols
       if (lce_local < lce_local_max || lce_local == lce_max) {
-        return lce_local;
+        lce = lce_local;
+        return true;
       }
-      l_ = m_pred.successor(l).pos;
-      r_ = m_pred.successor(r).pos;
+      l_ = successor(l, cache).pos;
+      r_ = successor(r, cache).pos;
     }
+    return false;
+  }
+
+  // Return the number of common letters in text[l..] and text[r..], when the
+  // first 3*tau symbols match. Here l_ and r_ are the indexes of the
+  // succeeding synchronizing positions of l and r.
+  size_t lce_synchronized(size_t l, size_t r, size_t l_, size_t r_) const {
+    std::vector<t_index_type> const& sss = m_sync_set.get_sss();
 
     if (sss[l_] - l != sss[r_] - r) {
       // Case 1: Positions l' and r' don't sync, (because they are at the end of
       // runs).
       size_t final_lce = std::min(sss[l_] - l, sss[r_] - r) + 2 * t_tau - 1;
-      assert(final_lce == alx::lce::lce_naive_wordwise<t_char_type>::lce_lr(
+      assert(final_lce == alx::lce::lce_naive_simd<t_char_type>::lce_lr(
                               m_text, m_size, l, r));
       return final_lce;
     } else {
       // Case 2: Positions l' and r' are synchronized.
       size_t final_lce = (sss[l_] - l) + m_fp_lce.lce_lr(l_, r_);
-      assert(final_lce == alx::lce::lce_naive_wordwise<t_char_type>::lce_lr(
+      assert(final_lce == alx::lce::lce_naive_simd<t_char_type>::lce_lr(
                               m_text, m_size, l, r));
       return final_lce;
     }
   }
 
-  // Return {b, lce}, where lce is the number of common letters in text[i..]
-  // and text[j..] and b tells whether the lce ends with a mismatch.
-  std::pair<bool, size_t> lce_mismatch(size_t i, size_t j) {
-    if (i == j) [[unlikely]] {
-      assert(i < m_size);
-      return {false, m_size - i};
-    }
-
-    size_t l = std::min(i, j);
-    size_t r = std::max(i, j);
-
-    size_t lce = lce_lr(l, r);
-    return {r + lce != m_size, lce};
-  }
-
-  // Return whether text[i..] is lexicographic smaller than text[j..]. Here i
-  // and j must be different.
-  bool is_leq_suffix(size_t i, size_t j) {
-    assert(i != j);
-    size_t lce_val = lce_uneq(i, j);
-    return (
-        i + lce_val == m_size ||
-        ((j + lce_val != m_size) && m_text[i + lce_val] < m_text[j + lce_val]));
-  }
-
-  char_type operator[](size_t i) { return m_text[i]; }
-
-  size_t size() { return m_size; }
-
- private:
   char_type const* m_text;
   size_t m_size;
 
   alx::pred::pred_index<t_index_type, std::bit_width(t_tau) - 1, t_index_type>
       m_pred;
   rolling_hash::sss<t_index_type, t_tau> m_sync_set;
-  alx::lce::lce_classic_for_sss<t_index_type, t_tau> m_fp_lce;
+  alx::lce::lce_classic_for_sss<t_index_type, t_tau, t_construction> m_fp_lce;
 };
 }  // namespace alx::lce
 /******************************************************************************/
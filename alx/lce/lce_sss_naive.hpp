@@ -8,12 +8,15 @@
 
 #pragma once
 
+#include <array>
 #include <chrono>
 #include <cmath>
 #include <memory>
+#include <span>
 #include <vector>
 
-#include "lce/lce_naive_wordwise.hpp"
+#include "lce/lce_naive_simd.hpp"
+#include "lce/suffix_comparison.hpp"
 #include "pred/pred_index.hpp"
 #include "rolling_hash/string_synchronizing_set.hpp"
 
@@ -29,12 +32,19 @@
 
 namespace alx::lce {
 
+// With t_compact_fps, the fingerprints of the sss are stored with 64 instead
+// of 128 bits, see rolling_hash::sss.
 template <typename t_char_type = uint8_t, uint64_t t_tau = 1024,
-          typename t_index_type = uint32_t, bool t_prefer_long = false>
+          typename t_index_type = uint32_t, bool t_prefer_long = false,
+          bool t_compact_fps = false>
 class lce_sss_naive {
  public:
   typedef t_char_type char_type;
   __extension__ typedef unsigned __int128 uint128_t;
+  typedef rolling_hash::sss<t_index_type, t_tau, rolling_hash::rk_prime<>,
+                            t_compact_fps>
+      sss_type;
+  typedef typename sss_type::stored_fp_type fp_type;
 
   lce_sss_naive() : m_text(nullptr), m_size(0) {}
 
@@ -50,7 +60,7 @@ class lce_sss_naive {
 #endif
 #endif
 
-    m_sync_set = rolling_hash::sss<t_index_type, t_tau>(text, size, true);
+    m_sync_set = sss_type(text, size, true);
     // check_string_synchronizing_set(text, m_sync_set);
 
 #ifdef ALX_BENCHMARK_INTERNAL
@@ -110,9 +120,22 @@ class lce_sss_naive {
   // Return the number of common letters in text[i..] and text[j..].
   // Here l must be smaller than r.
   inline uint64_t lce_lr(size_t l, size_t r) const {
+    size_t lce_local, l_, r_;
+    // Case 0: Mismatch at first 3*tau symbols
+    if (lce_scan_local(l, r, lce_local, l_, r_)) {
+      return lce_local;
+    }
+    return lce_synchronized(l, r, l_, r_);
+  }
+
+ private:
+  // Compare the first 3*tau symbols of text[l..] and text[r..]. If the lce
+  // ends there, store it in lce and return true. Otherwise store the indexes of
+  // the succeeding synchronizing positions in l_ and r_ and return false.
+  bool lce_scan_local(size_t l, size_t r, size_t& lce, size_t& l_,
+                      size_t& r_) const {
     std::vector<t_index_type> const& sss = m_sync_set.get_sss();
-    std::vector<uint128_t> const& fps = m_sync_set.get_fps();
-    size_t l_, r_;
+
     if constexpr (t_prefer_long) {
       // Only scan until synchronizing position
       size_t lce_max{m_size - r};
@@ -127,27 +150,38 @@ class lce_sss_naive {
             std::min(lce_local_max, static_cast<size_t>(sss[l_] - l));
       }
 
-      size_t lce_local = alx::lce::lce_naive_wordwise<t_char_type>::lce_lr(
+      size_t lce_local = alx::lce::lce_naive_simd<t_char_type>::lce_lr(
           m_text, r + lce_local_max, l, r);
 
       // Case 0: Mismatch at first 3*tau symbols
       if (lce_local < lce_local_max || lce_local == lce_max) {
-        return lce_local;
+        lce = lce_local;
+        return true;
       }
     } else {
       // Naive part until synchronizing position
       size_t lce_max{m_size - r};
       size_t lce_local_max{std::min(3 * t_tau, lce_max)};
-      size_t lce_local = alx::lce::lce_naive_wordwise<t_char_type>::lce_lr(
+      size_t lce_local = alx::lce::lce_naive_simd<t_char_type>::lce_lr(
           m_text, r + lce_local_max, l, r);
 
       // Case 0: Mismatch at first 3*tau symbols
       if (lce_local < lce_local_max || lce_local == lce_max) {
-        return lce_local;
+        lce = lce_local;
+        return true;
       }
       l_ = m_pred.successor(l).pos;
       r_ = m_pred.successor(r).pos;
     }
+    return false;
+  }
+
+  // Return the number of common letters in text[l..] and text[r..], when the
+  // first 3*tau symbols match. Here l_ and r_ are the indexes of the
+  // succeeding synchronizing positions of l and r.
+  size_t lce_synchronized(size_t l, size_t r, size_t l_, size_t r_) const {
+    std::vector<t_index_type> const& sss = m_sync_set.get_sss();
+    std::vector<fp_type> const& fps = m_sync_set.get_fps();
 
     // Case 1: Positions l' and r' don't sync, (because they are at the end of
     // runs).
@@ -155,7 +189,7 @@ class lce_sss_naive {
       return std::min(sss[l_] - l, sss[r_] - r) + 2 * t_tau - 1;
     }
 
-    size_t block_lce = alx::lce::lce_naive_std<uint128_t>::lce_lr(
+    size_t block_lce = alx::lce::lce_naive_std<fp_type>::lce_lr(
         fps.data(), fps.size(), l_, r_);
     size_t l__ = l_ + block_lce;
     size_t r__ = r_ + block_lce;
@@ -166,7 +200,7 @@ class lce_sss_naive {
     {
       size_t lce_max{m_size - sss[r__]};
       size_t lce_local_max{std::min(3 * t_tau, lce_max)};
-      size_t lce_local = alx::lce::lce_naive_wordwise<t_char_type>::lce_lr(
+      size_t lce_local = alx::lce::lce_naive_simd<t_char_type>::lce_lr(
           m_text, sss[r__] + lce_local_max, sss[l__], sss[r__]);
       if (lce_local < lce_local_max || lce_local == lce_max) {
         return (sss[l__] - l) + lce_local;
@@ -177,14 +211,60 @@ class lce_sss_naive {
     assert(r__ + 1 < sss.size() - 1);
     size_t final_lce =
         std::min(sss[l__ + 1] - l, sss[r__ + 1] - r) + 2 * t_tau - 1;
-    assert(final_lce == alx::lce::lce_naive_wordwise<t_char_type>::lce_lr(
+    assert(final_lce == alx::lce::lce_naive_simd<t_char_type>::lce_lr(
                             m_text, m_size, l, r));
     return final_lce;
   }
 
+ public:
+  // Store the number of common letters in text[i..] and text[j..] in out[k]
+  // for each query (i, j) = queries[k]. Groups of queries are answered stage
+  // by stage, so the cache misses of one group overlap.
+  void lce_batch(std::span<const std::pair<size_t, size_t>> queries,
+                 std::span<size_t> out) const {
+    assert(out.size() >= queries.size());
+    std::array<pending_query, m_batch_group_size> pending;
+
+    for (size_t begin = 0; begin < queries.size();
+         begin += m_batch_group_size) {
+      size_t const end = std::min(begin + m_batch_group_size, queries.size());
+      // Stage 1: Prefetch the text at both positions.
+      for (size_t k = begin; k < end; ++k) {
+        __builtin_prefetch(m_text + queries[k].first);
+        __builtin_prefetch(m_text + queries[k].second);
+      }
+      // Stage 2: Scan the first 3*tau symbols. For the remaining queries
+      // prefetch what is read after the synchronizing positions.
+      size_t num_pending = 0;
+      for (size_t k = begin; k < end; ++k) {
+        auto const [i, j] = queries[k];
+        if (i == j) [[unlikely]] {
+          assert(i < m_size);
+          out[k] = m_size - i;
+          continue;
+        }
+        pending_query& q = pending[num_pending];
+        q.k = k;
+        q.l = std::min(i, j);
+        q.r = std::max(i, j);
+        if (!lce_scan_local(q.l, q.r, out[k], q.l_, q.r_)) {
+          std::vector<fp_type> const& fps = m_sync_set.get_fps();
+          __builtin_prefetch(&fps[q.l_]);
+          __builtin_prefetch(&fps[q.r_]);
+          ++num_pending;
+        }
+      }
+      // Stage 3: Answer the remaining queries.
+      for (size_t p = 0; p < num_pending; ++p) {
+        pending_query const& q = pending[p];
+        out[q.k] = lce_synchronized(q.l, q.r, q.l_, q.r_);
+      }
+    }
+  }
+
   // Return {b, lce}, where lce is the number of common letters in text[i..]
   // and text[j..] and b tells whether the lce ends with a mismatch.
-  std::pair<bool, size_t> lce_mismatch(size_t i, size_t j) {
+  std::pair<bool, size_t> lce_mismatch(size_t i, size_t j) const {
     if (i == j) [[unlikely]] {
       assert(i < m_size);
       return {false, m_size - i};
@@ -199,7 +279,7 @@ class lce_sss_naive {
 
   // Return whether text[i..] is lexicographic smaller than text[j..]. Here i
   // and j must be different.
-  bool is_leq_suffix(size_t i, size_t j) {
+  bool is_leq_suffix(size_t i, size_t j) const {
     assert(i != j);
     size_t lce_val = lce_uneq(i, j);
     return (
@@ -207,11 +287,17 @@ class lce_sss_naive {
         ((j + lce_val != m_size) && m_text[i + lce_val] < m_text[j + lce_val]));
   }
 
+  // Return the comparison of text[i..] and text[j..], see suffix_comparison.
+  suffix_comparison<char_type> compare_suffixes(size_t i, size_t j) const {
+    size_t lce_val = lce(i, j);
+    return make_suffix_comparison(m_text, m_size, i, j, lce_val);
+  }
+
   // Return the lce of text[i..i+lce) and text[j..j+lce]
-  size_t lce_up_to(size_t i, size_t j, size_t up_to) {
+  size_t lce_up_to(size_t i, size_t j, size_t up_to) const {
     if (i == j) [[unlikely]] {
       assert(i < m_size);
-      m_size - i;
+      return std::min(m_size - i, up_to);
     }
 
     size_t l = std::min(i, j);
@@ -220,44 +306,49 @@ class lce_sss_naive {
     // Naive part until synchronizing position
     size_t lce_max{std::min(m_size - r, up_to)};
     size_t lce_local_max{std::min(3 * t_tau, lce_max)};
-    size_t lce_local = alx::lce::lce_naive_wordwise<t_char_type>::lce_lr(
+    size_t lce_local = alx::lce::lce_naive_simd<t_char_type>::lce_lr(
         m_text, r + lce_local_max, l, r);
 
     return lce_local;
 
     // From synchronizing position
     std::vector<t_index_type> const& sss = m_sync_set.get_sss();
-    std::vector<uint128_t> const& fps = m_sync_set.get_fps();
+    std::vector<fp_type> const& fps = m_sync_set.get_fps();
 
     size_t l_ = m_pred.successor(l).pos;
     size_t r_ = m_pred.successor(r).pos;
 
     size_t block_lce_max = sss.size() - r_;
-    size_t block_lce = alx::lce::lce_naive_std<uint128_t>::lce_lr(
+    size_t block_lce = alx::lce::lce_naive_std<fp_type>::lce_lr(
         fps.data(), fps.size(), l_, r_);
 
     size_t l_mm = sss[l_ + block_lce - 1];
     size_t r_mm = sss[r_ + block_lce - 1];
 
-    size_t lce_rest = alx::lce::lce_naive_wordwise<t_char_type>::lce_lr(
+    size_t lce_rest = alx::lce::lce_naive_simd<t_char_type>::lce_lr(
         m_text, m_size, l_mm, r_mm);
 
     size_t lce = (l_mm - l) + lce_rest;
     return lce;
   }
 
-  char_type operator[](size_t i) { return m_text[i]; }
+  char_type operator[](size_t i) const { return m_text[i]; }
 
-  size_t size() { return m_size; }
+  size_t size() const { return m_size; }
 
  private:
- private:
+  // A query of lce_batch, whose lce exceeds the first 3*tau symbols.
+  struct pending_query {
+    size_t k, l, r, l_, r_;
+  };
+  static constexpr size_t m_batch_group_size = 16;
+
   char_type const* m_text;
   size_t m_size;
 
   alx::pred::pred_index<t_index_type, std::bit_width(t_tau) - 1, t_index_type>
       m_pred;
-  rolling_hash::sss<t_index_type, t_tau> m_sync_set;
+  sss_type m_sync_set;
 };
 }  // namespace alx::lce
 /******************************************************************************/
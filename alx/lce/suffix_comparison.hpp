@@ -0,0 +1,54 @@
+/*******************************************************************************
+ * alx/lce/suffix_comparison.hpp
+ *
+ * Copyright (C) 2026 Alexander Herlez <alexander.herlez@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <compare>
+#include <cstddef>
+
+namespace alx::lce {
+
+// The result of comparing text[i..] with text[j..]: their lexicographic order,
+// their lce and the characters text[i+lce] and text[j+lce] following it. If one
+// of the suffixes ends after the lce, both characters are 0. The LCE data
+// structures return it from compare_suffixes(i, j), so that a suffix sorter
+// learns the order and the lce from a single query.
+template <typename t_char_type>
+struct suffix_comparison {
+  std::strong_ordering order;
+  size_t lce;
+  t_char_type mismatch_i;
+  t_char_type mismatch_j;
+};
+
+// Return the comparison of text[i..] and text[j..] of a text of the given
+// size, when their lce and the characters following it are known.
+template <typename t_char_type>
+suffix_comparison<t_char_type> make_suffix_comparison(size_t size, size_t i,
+                                                      size_t j, size_t lce,
+                                                      t_char_type char_i,
+                                                      t_char_type char_j) {
+  if (i + lce == size || j + lce == size) {
+    // One suffix is a prefix of the other one, so the shorter one is smaller.
+    return {j <=> i, lce, t_char_type{0}, t_char_type{0}};
+  }
+  return {char_i <=> char_j, lce, char_i, char_j};
+}
+
+// Return the comparison of text[i..] and text[j..] when their lce is known.
+template <typename t_char_type>
+suffix_comparison<t_char_type> make_suffix_comparison(t_char_type const* text,
+                                                      size_t size, size_t i,
+                                                      size_t j, size_t lce) {
+  if (i + lce == size || j + lce == size) {
+    return make_suffix_comparison<t_char_type>(size, i, j, lce, 0, 0);
+  }
+  return make_suffix_comparison(size, i, j, lce, text[i + lce], text[j + lce]);
+}
+
+}  // namespace alx::lce
@@ -0,0 +1,154 @@
+/*******************************************************************************
+ * alx/rmq/rmq_bit.hpp
+ *
+ * Copyright (C) 2026 Alexander Herlez <alexander.herlez@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <assert.h>
+#include <omp.h>
+
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+#include "rmq_nlgn.hpp"
+
+namespace alx::rmq {
+
+// RMQ with blocks of 64 elements, like rmq_n, but without scanning. For each
+// position i we store a 64 bit mask of the stack of the left-to-right minima
+// of its block after pushing i: bit k is set iff data[b+k] <= data[x] for all
+// x in (b+k, i], where b is the begin of the block. The minimum of
+// data[b+l..i] is then at the lowest set bit of mask[i] that is at least l,
+// i.e., it is found with one tzcnt. The block minima are kept in an rmq_nlgn.
+template <typename t_key_type, typename index_type = uint32_t>
+class rmq_bit {
+  static constexpr uint64_t block_size = 64;
+
+ public:
+  using key_type = t_key_type;
+  rmq_bit() {
+  }
+
+  rmq_bit(key_type const* data, size_t size) : m_data(data), m_size(size) {
+    // The sampled indexes must fit into index_type.
+    assert(static_cast<size_t>(static_cast<index_type>(m_size - 1)) ==
+           m_size - 1);
+    size_t const num_blocks = (m_size - 1) / block_size + 1;
+    m_masks.resize(m_size);
+    m_sampled_indexes.resize(num_blocks);
+    m_sampled_minimas.resize(num_blocks);
+
+#pragma omp parallel for
+    for (size_t block = 0; block < num_blocks; ++block) {
+      size_t const begin = block * block_size;
+      size_t const end = std::min(begin + block_size, m_size);
+      uint64_t stack = 0;
+      for (size_t i = begin; i < end; ++i) {
+        // Pop all larger elements. The stack is sorted by position and value,
+        // so these are the highest set bits.
+        while (stack != 0) {
+          size_t const top = begin + std::bit_width(stack) - 1;
+          if (m_data[top] <= m_data[i]) {
+            break;
+          }
+          stack ^= uint64_t{1} << (top - begin);
+        }
+        stack |= uint64_t{1} << (i - begin);
+        m_masks[i] = stack;
+      }
+      // The bottom of the stack is the leftmost minimum of the block.
+      size_t const min_index = begin + std::countr_zero(stack);
+      m_sampled_indexes[block] = min_index;
+      m_sampled_minimas[block] = m_data[min_index];
+    }
+
+    // Build an RMQ data structure for these block minimas.
+    m_sampled_rmq = rmq_nlgn<key_type, index_type>(m_sampled_minimas);
+  }
+
+  template <typename C>
+  rmq_bit(C const& container) : rmq_bit(container.data(), container.size()) {
+  }
+
+  // Return the index of the smallest element in m_data[left]..m_data[right]
+  // for left = std::min(i, j) and right = std::max(i, j).
+  size_t rmq(size_t const i, size_t const j) const {
+    size_t const left = std::min(i, j);
+    size_t const right = std::max(i, j);
+    return rmq_lr(left, right);
+  }
+
+  // Return the index of the smallest element in m_data[left]..m_data[right].
+  // Here left must be no more than right.
+  size_t rmq_lr(size_t const left, size_t const right) const {
+    assert(left <= right);
+    assert(right < m_size);
+    size_t const l_block = left / block_size;
+    size_t const r_block = right / block_size;
+    if (l_block == r_block) {
+      return in_block_rmq(left, right);
+    }
+
+    // Min in left and right block
+    size_t const min_beg =
+        in_block_rmq(left, l_block * block_size + block_size - 1);
+    size_t const min_end = in_block_rmq(r_block * block_size, right);
+    size_t min = min_beg;
+    if (l_block + 1 < r_block) {
+      // Now look for min in middle part.
+      size_t const min_mid =
+          m_sampled_indexes[m_sampled_rmq.rmq(l_block + 1, r_block - 1)];
+      min = m_data[min] <= m_data[min_mid] ? min : min_mid;
+    }
+    return m_data[min] <= m_data[min_end] ? min : min_end;
+  }
+
+  // Return the index of the smallest element in m_data[left+1]..m_data[right]
+  // for left = std::min(i, j) and right = std::max(i, j). Useful for the
+  // LCP array.
+  size_t rmq_shifted(size_t const i, size_t const j) const {
+    assert(i != j);
+    size_t const left = std::min(i, j) + 1;
+    size_t const right = std::max(i, j);
+    return rmq_lr(left, right);
+  }
+
+  // Prefetch the memory read by rmq_shifted(i, j). This allows to overlap the
+  // cache misses of independent queries.
+  void prefetch_shifted(size_t const i, size_t const j) const {
+    size_t const left = std::min(i, j) + 1;
+    size_t const right = std::max(i, j);
+    size_t const l_block = left / block_size;
+    size_t const r_block = right / block_size;
+    __builtin_prefetch(&m_masks[right]);
+    if (l_block != r_block) {
+      __builtin_prefetch(&m_masks[l_block * block_size + block_size - 1]);
+    }
+    if (l_block + 1 < r_block) {
+      m_sampled_rmq.prefetch_lr(l_block + 1, r_block - 1);
+    }
+  }
+
+ private:
+  // Return the index of the smallest element in m_data[left]..m_data[right],
+  // where both are in the same block.
+  size_t in_block_rmq(size_t const left, size_t const right) const {
+    assert(left / block_size == right / block_size);
+    size_t const offset = left % block_size;
+    return left + std::countr_zero(m_masks[right] >> offset);
+  }
+
+  key_type const* m_data = nullptr;
+  size_t m_size;
+
+  std::vector<uint64_t> m_masks;
+  std::vector<index_type> m_sampled_indexes;
+  std::vector<key_type> m_sampled_minimas;
+  rmq_nlgn<key_type, index_type> m_sampled_rmq;
+};  // class rmq_bit
+}  // namespace alx::rmq
@@ -26,6 +26,9 @@ class rmq_n {
   }
 
   rmq_n(key_type const* data, size_t size) : m_data(data), m_size(size) {
+    // The sampled indexes must fit into index_type.
+    assert(static_cast<size_t>(static_cast<index_type>(m_size - 1)) ==
+           m_size - 1);
     const uint64_t num_sampled_elements = (m_size - 1) / t_block_size + 1;
     m_sampled_indexes.resize(num_sampled_elements);
     m_sampled_minimas.resize(num_sampled_elements);
@@ -33,8 +36,8 @@ class rmq_n {
 // Get the minimal elements from the blocks.
 #pragma omp parallel for
     for (size_t block = 0; block < num_sampled_elements; ++block) {
-      index_type min_index = block * t_block_size;
-      index_type end = std::min(((1 + block) * t_block_size), m_size);
+      size_t min_index = block * t_block_size;
+      size_t const end = std::min(((1 + block) * t_block_size), m_size);
       for (size_t i = min_index; i < end; ++i) {
         min_index = data[min_index] <= data[i] ? min_index : i;
       }
@@ -43,7 +46,7 @@ class rmq_n {
     }
 
     // Build an RMQ data structure for these block minimas.
-    m_sampled_rmq = rmq_nlgn<key_type>(m_sampled_minimas);
+    m_sampled_rmq = rmq_nlgn<key_type, index_type>(m_sampled_minimas);
   }
 
   template <typename C>
@@ -108,6 +111,19 @@ class rmq_n {
     return rmq_lr(left, right);
   }
 
+  // Prefetch the memory read by rmq_shifted(i, j). This allows to overlap the
+  // cache misses of independent queries.
+  void prefetch_shifted(size_t const i, size_t const j) const {
+    size_t const left = std::min(i, j) + 1;
+    size_t const right = std::max(i, j);
+    __builtin_prefetch(m_data + left);
+    __builtin_prefetch(m_data + right);
+    if (right - left > 3 * t_block_size) {
+      m_sampled_rmq.prefetch_lr((left / t_block_size) + 1,
+                                (right / t_block_size) - 1);
+    }
+  }
+
  private:
   key_type const* m_data = nullptr;
   size_t m_size;
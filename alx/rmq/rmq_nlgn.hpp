@@ -11,12 +11,24 @@
 #include <assert.h>
 #include <omp.h>
 
+#include <bit>
+#include <cstdint>
+#include <type_traits>
 #include <vector>
 
+#include "util/huge_page_allocator.hpp"
+
 namespace alx::rmq {
 
+// Sparse table: level l stores the position of the minimum of each interval of
+// length 2^l. The positions are stored relative to the begin of the interval,
+// so each entry needs only as many bytes as the level requires (1, 2, 4 or 8),
+// independent of index_type. All levels share one allocation backed by huge
+// pages.
 template <typename t_key_type, typename index_type = uint32_t>
 class rmq_nlgn {
+  static constexpr size_t cache_line_size = 64;
+
  public:
   using key_type = t_key_type;
   rmq_nlgn() {
@@ -24,31 +36,47 @@ class rmq_nlgn {
 
   rmq_nlgn(key_type const* data, size_t size) : m_data(data) {
     assert(size != 0);
-    const uint8_t m_num_levels = std::bit_width(size) - 1;
-    m_power_rmq.resize(m_num_levels);
-
-    // Build first level
-    if (!m_power_rmq.empty()) {
-      m_power_rmq[0].resize(size - 1);
+    size_t const num_levels = std::bit_width(size) - 1;
+
+    // Level l begins at byte m_level_begin[l] and is cache line aligned. There
+    // is no level 0.
+    m_level_begin.resize(num_levels + 1);
+    size_t bytes = 0;
+    for (size_t l = 1; l <= num_levels; ++l) {
+      m_level_begin[l] = bytes;
+      bytes += (size - (size_t{1} << l) + 1) * offset_width(l);
+      bytes = (bytes + cache_line_size - 1) / cache_line_size * cache_line_size;
     }
+    m_table.resize(bytes);
 
+    // Build first level
+    if (num_levels >= 1) {
+      uint8_t* const first_level = level(1);
 #pragma omp parallel for
-    for (size_t i = 0; i < size - 1; ++i) {
-      m_power_rmq[0][i] = m_data[i] <= data[i + 1] ? i : (i + 1);
+      for (size_t i = 0; i < size - 1; ++i) {
+        first_level[i] = m_data[i] <= m_data[i + 1] ? 0 : 1;
+      }
     }
 
     // Build the rest
-    for (size_t l = 1; l < m_num_levels; ++l) {
-      m_power_rmq[l].resize(size - ((uint64_t{2} << l) - 1));
-      uint32_t const span = (uint64_t{1} << l);
+    for (size_t l = 2; l <= num_levels; ++l) {
+      size_t const span = size_t{1} << (l - 1);
+      size_t const level_size = size - (size_t{1} << l) + 1;
+      with_level(level(l - 1), l - 1, [&](auto const* prev_level) {
+        with_level(level(l), l, [&](auto* cur_level) {
+          using offset_type = std::remove_pointer_t<decltype(cur_level)>;
 #pragma omp parallel for
-      for (size_t i = 0; i < m_power_rmq[l].size(); ++i) {
-        const uint32_t l_interval_min = m_power_rmq[l - 1][i];
-        const uint32_t r_interval_min = m_power_rmq[l - 1][i + span];
-        m_power_rmq[l][i] = m_data[l_interval_min] <= m_data[r_interval_min]
-                                ? l_interval_min
-                                : r_interval_min;
-      }
+          for (size_t i = 0; i < level_size; ++i) {
+            size_t const l_interval_min = i + prev_level[i];
+            size_t const r_interval_min = i + span + prev_level[i + span];
+            cur_level[i] = static_cast<offset_type>(
+                (m_data[l_interval_min] <= m_data[r_interval_min]
+                     ? l_interval_min
+                     : r_interval_min) -
+                i);
+          }
+        });
+      });
     }
   }
 
@@ -78,13 +106,12 @@ class rmq_nlgn {
   // Here left must be smaller than right.
   size_t rmq_lr(size_t const left, size_t const right) const {
     assert(left < right);
-    const uint32_t interval_size = right - left + 1;
-
-    const uint32_t interval_log = std::bit_width(interval_size) - 1;
-    const uint32_t max_power_span = (1ULL << interval_log);
-    const uint32_t l_interval_min = m_power_rmq[interval_log - 1][left];
-    const uint32_t r_interval_min =
-        m_power_rmq[interval_log - 1][right + 1 - max_power_span];
+    size_t const interval_log = std::bit_width(right - left + 1) - 1;
+    size_t const max_power_span = size_t{1} << interval_log;
+    uint8_t const* const entries = level(interval_log);
+    size_t const l_interval_min = level_min(entries, interval_log, left);
+    size_t const r_interval_min =
+        level_min(entries, interval_log, right + 1 - max_power_span);
 
     return m_data[l_interval_min] <= m_data[r_interval_min] ? l_interval_min
                                                             : r_interval_min;
@@ -98,25 +125,73 @@ class rmq_nlgn {
     size_t const left = std::min(i, j) + 1;
     size_t const right = std::max(i, j);
 
-    // We can not use rmq_lr because interval_size could be one.
-    const uint32_t interval_size = right - left + 1;
-    if (interval_size <= 2) {
+    // We can not use rmq_lr because the interval size could be one.
+    if (right - left + 1 <= 2) {
       return m_data[left] <= m_data[right] ? left : right;
     }
+    return rmq_lr(left, right);
+  }
+
+  // Prefetch the table entries read by rmq_lr(left, right).
+  void prefetch_lr(size_t const left, size_t const right) const {
+    size_t const interval_log = std::bit_width(right - left + 1) - 1;
+    if (interval_log == 0) {
+      return;
+    }
+    size_t const max_power_span = size_t{1} << interval_log;
+    uint8_t const* const entries = level(interval_log);
+    size_t const width = offset_width(interval_log);
+    __builtin_prefetch(entries + left * width);
+    __builtin_prefetch(entries + (right + 1 - max_power_span) * width);
+  }
 
-    const uint32_t interval_log = std::bit_width(interval_size) - 1;
-    const uint32_t max_power_span = (1ULL << interval_log);
-    const uint32_t l_interval_min = m_power_rmq[interval_log - 1][left];
-    const uint32_t r_interval_min =
-        m_power_rmq[interval_log - 1][right + 1 - max_power_span];
+  // Number of bytes of the entries of level l. An entry is smaller than 2^l.
+  static constexpr size_t offset_width(size_t const l) {
+    return l <= 8 ? 1 : (l <= 16 ? 2 : (l <= 32 ? 4 : 8));
+  }
 
-    return m_data[l_interval_min] <= m_data[r_interval_min] ? l_interval_min
-                                                            : r_interval_min;
+  // Call fn with a pointer to the entries of level l, which begin at level,
+  // typed by their width.
+  template <typename t_fn>
+  static void with_level(uint8_t* const level, size_t const l, t_fn fn) {
+    if (l <= 8) {
+      fn(level);
+    } else if (l <= 16) {
+      fn(reinterpret_cast<uint16_t*>(level));
+    } else if (l <= 32) {
+      fn(reinterpret_cast<uint32_t*>(level));
+    } else {
+      fn(reinterpret_cast<uint64_t*>(level));
+    }
+  }
+
+  // Return the index of the smallest element in m_data[i]..m_data[i+2^l-1],
+  // where the entries of level l begin at level.
+  static size_t level_min(uint8_t const* const level, size_t const l,
+                          size_t const i) {
+    if (l <= 8) {
+      return i + level[i];
+    } else if (l <= 16) {
+      return i + reinterpret_cast<uint16_t const*>(level)[i];
+    } else if (l <= 32) {
+      return i + reinterpret_cast<uint32_t const*>(level)[i];
+    }
+    return i + reinterpret_cast<uint64_t const*>(level)[i];
   }
 
  private:
+  // Return the begin of the entries of level l.
+  uint8_t* level(size_t const l) {
+    return m_table.data() + m_level_begin[l];
+  }
+
+  uint8_t const* level(size_t const l) const {
+    return m_table.data() + m_level_begin[l];
+  }
+
   key_type const* m_data = nullptr;
-  std::vector<std::vector<index_type>> m_power_rmq;
+  std::vector<uint8_t, alx::util::huge_page_allocator<uint8_t>> m_table;
+  std::vector<size_t> m_level_begin;
 
 };  // class rmq_nlgn
 }  // namespace alx::rmq
\ No newline at end of file
@@ -0,0 +1,92 @@
+/*******************************************************************************
+ * alx/rmq/rmq_offline.hpp
+ *
+ * Copyright (C) 2026 Alexander Herlez <alexander.herlez@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <assert.h>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace alx::rmq {
+
+// Answer range minimum queries offline. For each k, report(k, min) is called
+// with min the index of the smallest element in data[left]..data[right] for
+// {left, right} = ranges[k], where left <= right. Ties are broken to the left.
+//
+// The ranges are swept by their right end (Tarjan's offline algorithm): The
+// stack of left-to-right minima of data[0..right] is kept in a union-find
+// forest, in which each index points towards the stack element that is the
+// minimum of all ranges starting at the index. This needs O((n + m) alpha(n))
+// time and no RMQ data structure.
+//
+// The caller provides parent with space for size entries, e.g., memory that is
+// not needed anymore. The number of ranges must fit into t_index_type.
+template <typename t_key_type, typename t_index_type, typename t_range_type,
+          typename t_report_fn>
+void rmq_offline(t_key_type const* data, size_t size,
+                 std::span<t_range_type const> ranges, t_index_type* parent,
+                 t_report_fn report) {
+  // Sort the ranges by their right end with a counting sort. The counters are
+  // stored in parent.
+  std::fill_n(parent, size, 0);
+  for (auto const& range : ranges) {
+    assert(range.first <= range.second && range.second < size);
+    parent[range.second] = static_cast<size_t>(parent[range.second]) + 1;
+  }
+  size_t sum = 0;
+  for (size_t i = 0; i < size; ++i) {
+    size_t const count = parent[i];
+    parent[i] = sum;
+    sum += count;
+  }
+  std::vector<t_index_type> order(ranges.size());
+  for (size_t k = 0; k < ranges.size(); ++k) {
+    size_t const pos = parent[ranges[k].second];
+    parent[ranges[k].second] = pos + 1;
+    order[pos] = k;
+  }
+
+  // Sweep. Index i is added to the forest when it is pushed.
+  auto const find = [parent](size_t x) {
+    while (static_cast<size_t>(parent[x]) != x) {
+      parent[x] = parent[static_cast<size_t>(parent[x])];
+      x = parent[x];
+    }
+    return x;
+  };
+  std::vector<t_index_type> stack;
+  size_t next = 0;
+  for (size_t i = 0; i < size && next < order.size(); ++i) {
+    while (!stack.empty() && data[stack.back()] > data[i]) {
+      parent[stack.back()] = i;
+      stack.pop_back();
+    }
+    parent[i] = i;
+    stack.push_back(i);
+    for (; next < order.size() && ranges[order[next]].second == i; ++next) {
+      size_t const k = order[next];
+      report(k, find(ranges[k].first));
+    }
+  }
+}
+
+// Return the index of the smallest element in data[left]..data[right] for each
+// {left, right} in ranges, see above.
+template <typename t_index_type = uint32_t, typename t_key_type,
+          typename t_range_type>
+std::vector<size_t> rmq_offline(t_key_type const* data, size_t size,
+                                std::span<t_range_type const> ranges) {
+  std::vector<t_index_type> parent(size);
+  std::vector<size_t> result(ranges.size());
+  rmq_offline(data, size, ranges, parent.data(),
+              [&result](size_t k, size_t min) { result[k] = min; });
+  return result;
+}
+}  // namespace alx::rmq
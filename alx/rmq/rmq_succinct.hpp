@@ -0,0 +1,346 @@
+/*******************************************************************************
+ * alx/rmq/rmq_succinct.hpp
+ *
+ * Copyright (C) 2026 Alexander Herlez <alexander.herlez@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <assert.h>
+#include <immintrin.h>
+#include <omp.h>
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace alx::rmq {
+
+// Succinct RMQ that does not access the data after construction. It stores the
+// balanced parentheses sequence P of the stack of left-to-right minima: First
+// '(' for a sentinel, then for each i a ')' for each element popped by i
+// (those larger than data[i]) and a '(' for pushing i. The k-th '(' belongs to
+// i = k - 1.
+//
+// Let E(p) be the excess (number of '(' minus number of ')') of P[0..p]. The
+// stack after pushing right holds the minimum of data[left..right] at the depth
+// E(q) + 1, where q is the last position with the minimal excess in
+// P[open(left)-1..open(right)]. Its '(' is at q + 1.
+//
+// P is split into blocks of 512 bits. For each block we store the number of
+// '(' before it, and a min tree stores the minimal excess of each block. With
+// 2n + 1 bits for P this needs about 2.4 bits per element.
+template <typename t_key_type, typename index_type = uint32_t>
+class rmq_succinct {
+  static constexpr size_t block_bits = 512;
+  static constexpr size_t block_words = block_bits / 64;
+  // Every select_sample-th '(' we store the block containing it.
+  static constexpr size_t select_sample = 512;
+
+ public:
+  using key_type = t_key_type;
+  rmq_succinct() {
+  }
+
+  rmq_succinct(key_type const* data, size_t size) : m_size(size) {
+    // The ranks and the excess values must fit into index_type.
+    assert(static_cast<size_t>(static_cast<index_type>(size + 1)) == size + 1);
+    // Write P.
+    m_bits.resize(((2 * size + 1) / block_bits + 1) * block_words);
+    std::vector<index_type> stack;
+    size_t pos = 0;
+    set_bit(pos++);
+    for (size_t i = 0; i < size; ++i) {
+      while (!stack.empty() && data[stack.back()] > data[i]) {
+        stack.pop_back();
+        ++pos;
+      }
+      set_bit(pos++);
+      stack.push_back(i);
+    }
+    m_num_bits = pos;
+    std::vector<index_type>().swap(stack);
+
+    // Count the '(' before each block.
+    size_t const num_blocks = m_bits.size() / block_words;
+    m_block_rank.resize(num_blocks + 1);
+#pragma omp parallel for
+    for (size_t b = 0; b < num_blocks; ++b) {
+      size_t count = 0;
+      for (size_t w = b * block_words; w < (b + 1) * block_words; ++w) {
+        count += std::popcount(m_bits[w]);
+      }
+      m_block_rank[b + 1] = count;
+    }
+    size_t rank = 0;
+    for (size_t b = 0; b < num_blocks; ++b) {
+      rank += m_block_rank[b + 1];
+      m_block_rank[b + 1] = rank;
+    }
+
+    // Build the min tree over the minimal excess of each block.
+    m_num_leaves = std::bit_ceil(num_blocks);
+    m_tree.resize(2 * m_num_leaves, static_cast<index_type>(~uint64_t{0}));
+#pragma omp parallel for
+    for (size_t b = 0; b < num_blocks; ++b) {
+      size_t const begin = b * block_bits;
+      size_t const end = std::min(begin + block_bits, m_num_bits);
+      if (begin < end) {
+        m_tree[m_num_leaves + b] = scan(begin, end - 1).first;
+      }
+    }
+    for (size_t v = m_num_leaves - 1; v > 0; --v) {
+      m_tree[v] = std::min(m_tree[2 * v], m_tree[2 * v + 1]);
+    }
+
+    // Sample the blocks for select.
+    m_select_samples.resize(size / select_sample + 2);
+    size_t block = 0;
+    for (size_t s = 0; s < m_select_samples.size(); ++s) {
+      size_t const k = std::min(s * select_sample, size);
+      while (m_block_rank[block + 1] <= k) {
+        ++block;
+      }
+      m_select_samples[s] = block;
+    }
+  }
+
+  template <typename C>
+  rmq_succinct(C const& container)
+      : rmq_succinct(container.data(), container.size()) {
+  }
+
+  // Return the index of the smallest element in m_data[left]..m_data[right]
+  // for left = std::min(i, j) and right = std::max(i, j).
+  size_t rmq(size_t const i, size_t const j) const {
+    size_t const left = std::min(i, j);
+    size_t const right = std::max(i, j);
+    return rmq_lr(left, right);
+  }
+
+  // Return the index of the smallest element in m_data[left]..m_data[right].
+  // Here left must be no more than right.
+  size_t rmq_lr(size_t const left, size_t const right) const {
+    assert(left <= right);
+    assert(right < m_size);
+    if (left == right) {
+      return left;
+    }
+    size_t const q = last_min_excess(select_open(left + 1) - 1,
+                                     select_open(right + 1));
+    return rank_open(q + 1) - 1;
+  }
+
+  // Return the index of the smallest element in m_data[left+1]..m_data[right]
+  // for left = std::min(i, j) and right = std::max(i, j). Useful for the
+  // LCP array.
+  size_t rmq_shifted(size_t const i, size_t const j) const {
+    assert(i != j);
+    size_t const left = std::min(i, j) + 1;
+    size_t const right = std::max(i, j);
+    return rmq_lr(left, right);
+  }
+
+  // Prefetch the select samples read by rmq_shifted(i, j).
+  void prefetch_shifted(size_t const i, size_t const j) const {
+    size_t const left = std::min(i, j) + 1;
+    size_t const right = std::max(i, j);
+    __builtin_prefetch(&m_select_samples[(left + 1) / select_sample]);
+    __builtin_prefetch(&m_select_samples[(right + 1) / select_sample]);
+  }
+
+  // Return the space of the data structure in bits per element.
+  double bits_per_element() const {
+    size_t const bytes = m_bits.size() * sizeof(uint64_t) +
+                         m_block_rank.size() * sizeof(index_type) +
+                         m_tree.size() * sizeof(index_type) +
+                         m_select_samples.size() * sizeof(index_type);
+    return m_size == 0 ? 0.0 : 8.0 * bytes / m_size;
+  }
+
+ private:
+  void set_bit(size_t const pos) {
+    m_bits[pos / 64] |= uint64_t{1} << (pos % 64);
+  }
+
+  bool get_bit(size_t const pos) const {
+    return (m_bits[pos / 64] >> (pos % 64)) & 1;
+  }
+
+  // Return the number of '(' in P[0..pos).
+  size_t rank_open(size_t const pos) const {
+    size_t const block = pos / block_bits;
+    size_t rank = m_block_rank[block];
+    for (size_t w = block * block_words; w < pos / 64; ++w) {
+      rank += std::popcount(m_bits[w]);
+    }
+    if (pos % 64 != 0) {
+      rank += std::popcount(m_bits[pos / 64] << (64 - pos % 64));
+    }
+    return rank;
+  }
+
+  // Return the position of the k-th '(' (counting from 0).
+  size_t select_open(size_t const k) const {
+    size_t const s = k / select_sample;
+    // The last block b in [lo, hi] with m_block_rank[b] <= k contains it.
+    size_t lo = m_select_samples[s];
+    size_t hi = m_select_samples[s + 1];
+    while (lo < hi) {
+      size_t const mid = (lo + hi + 1) / 2;
+      if (m_block_rank[mid] <= k) {
+        lo = mid;
+      } else {
+        hi = mid - 1;
+      }
+    }
+    size_t remaining = k - m_block_rank[lo];
+    for (size_t w = lo * block_words;; ++w) {
+      size_t const count = std::popcount(m_bits[w]);
+      if (remaining < count) {
+        return w * 64 + select_in_word(m_bits[w], remaining);
+      }
+      remaining -= count;
+    }
+  }
+
+  // Return the position of the k-th set bit in word.
+  static size_t select_in_word(uint64_t word, size_t const k) {
+#ifdef __BMI2__
+    return std::countr_zero(_pdep_u64(uint64_t{1} << k, word));
+#else
+    for (size_t i = 0; i < k; ++i) {
+      word &= word - 1;
+    }
+    return std::countr_zero(word);
+#endif
+  }
+
+  // Return E(pos - 1), i.e., the excess before pos.
+  int64_t excess_before(size_t const pos) const {
+    return 2 * static_cast<int64_t>(rank_open(pos)) - static_cast<int64_t>(pos);
+  }
+
+  // For each byte: the change of the excess, the minimal excess after one of
+  // its bits relative to the excess before it, and the last bit with it.
+  struct byte_excess {
+    int8_t delta;
+    int8_t min;
+    uint8_t min_pos;
+  };
+  static constexpr std::array<byte_excess, 256> byte_table = [] {
+    std::array<byte_excess, 256> table{};
+    for (size_t byte = 0; byte < 256; ++byte) {
+      int8_t excess = 0;
+      table[byte].min = 8;
+      for (uint8_t bit = 0; bit < 8; ++bit) {
+        excess += ((byte >> bit) & 1) ? 1 : -1;
+        if (excess <= table[byte].min) {
+          table[byte].min = excess;
+          table[byte].min_pos = bit;
+        }
+      }
+      table[byte].delta = excess;
+    }
+    return table;
+  }();
+
+  // Return the minimal excess in P[from..to] and the last position with it.
+  std::pair<int64_t, size_t> scan(size_t const from, size_t const to) const {
+    int64_t excess = excess_before(from);
+    int64_t min = std::numeric_limits<int64_t>::max();
+    size_t min_pos = from;
+    size_t pos = from;
+    for (; pos <= to && pos % 8 != 0; ++pos) {
+      excess += get_bit(pos) ? 1 : -1;
+      if (excess <= min) {
+        min = excess;
+        min_pos = pos;
+      }
+    }
+    for (; pos + 8 <= to + 1; pos += 8) {
+      byte_excess const entry =
+          byte_table[(m_bits[pos / 64] >> (pos % 64)) & 0xff];
+      if (excess + entry.min <= min) {
+        min = excess + entry.min;
+        min_pos = pos + entry.min_pos;
+      }
+      excess += entry.delta;
+    }
+    for (; pos <= to; ++pos) {
+      excess += get_bit(pos) ? 1 : -1;
+      if (excess <= min) {
+        min = excess;
+        min_pos = pos;
+      }
+    }
+    return {min, min_pos};
+  }
+
+  // Return the minimal excess of the blocks lo..hi and the last block with it.
+  std::pair<int64_t, size_t> tree_min(size_t const lo, size_t const hi) const {
+    // The nodes covering [lo, hi] from left to right are left_nodes and then
+    // right_nodes in reverse.
+    std::array<size_t, 64> left_nodes;
+    std::array<size_t, 64> right_nodes;
+    size_t num_left = 0;
+    size_t num_right = 0;
+    for (size_t l = lo + m_num_leaves, r = hi + m_num_leaves + 1; l < r;
+         l /= 2, r /= 2) {
+      if (l & 1) {
+        left_nodes[num_left++] = l++;
+      }
+      if (r & 1) {
+        right_nodes[num_right++] = --r;
+      }
+    }
+    size_t node = 0;
+    for (size_t k = 0; k < num_left; ++k) {
+      if (node == 0 || m_tree[left_nodes[k]] <= m_tree[node]) {
+        node = left_nodes[k];
+      }
+    }
+    for (size_t k = num_right; k > 0; --k) {
+      if (node == 0 || m_tree[right_nodes[k - 1]] <= m_tree[node]) {
+        node = right_nodes[k - 1];
+      }
+    }
+    // Descend to the last leaf with the minimum.
+    while (node < m_num_leaves) {
+      node = m_tree[2 * node + 1] == m_tree[node] ? 2 * node + 1 : 2 * node;
+    }
+    return {m_tree[node], node - m_num_leaves};
+  }
+
+  // Return the last position with the minimal excess in P[from..to].
+  size_t last_min_excess(size_t const from, size_t const to) const {
+    size_t const l_block = from / block_bits;
+    size_t const r_block = to / block_bits;
+    if (l_block == r_block) {
+      return scan(from, to).second;
+    }
+    auto const [r_min, r_pos] = scan(r_block * block_bits, to);
+    auto const [l_min, l_pos] = scan(from, (l_block + 1) * block_bits - 1);
+    if (l_block + 1 < r_block) {
+      auto const [m_min, m_block] = tree_min(l_block + 1, r_block - 1);
+      if (m_min < r_min && m_min <= l_min) {
+        return scan(m_block * block_bits, (m_block + 1) * block_bits - 1)
+            .second;
+      }
+    }
+    return r_min <= l_min ? r_pos : l_pos;
+  }
+
+  size_t m_size = 0;
+  size_t m_num_bits = 0;
+  size_t m_num_leaves = 0;
+  std::vector<uint64_t> m_bits;
+  std::vector<index_type> m_block_rank;
+  std::vector<index_type> m_tree;
+  std::vector<index_type> m_select_samples;
+};  // class rmq_succinct
+}  // namespace alx::rmq
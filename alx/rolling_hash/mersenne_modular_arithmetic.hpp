@@ -9,9 +9,12 @@
 #pragma once
 #include <assert.h>
 
+#include <algorithm>
+#include <array>
 #include <bit>
 #include <iterator>
 #include <random>
+#include <type_traits>
 
 // Return whether num is a mersenne prime.
 namespace alx::mersenne {
@@ -80,4 +83,41 @@ inline T additive_inverse_mod(T a) {
   assert(a < t_mersenne_prime);
   return small_num_mod<T, t_mersenne_prime>(t_mersenne_prime - a);
 }
+
+// Return a-b % prime. The two integers must already be reduced.
+template <typename T, T t_mersenne_prime>
+inline T sub_mod(T a, T b) {
+  static_assert(is_mersenne_prime(t_mersenne_prime));
+  assert(a < t_mersenne_prime && b < t_mersenne_prime);
+  return (a >= b) ? (a - b) : (a + (t_mersenne_prime - b));
+}
+
+// Return a*b % prime. The two integers must already be reduced. The product is
+// split into its lowest and highest bits, whose sum is congruent to it.
+template <typename T, T t_mersenne_prime>
+inline T mult_mod(T a, T b) {
+  static_assert(is_mersenne_prime(t_mersenne_prime));
+  static_assert(std::is_same_v<T, uint64_t>);
+  __extension__ typedef unsigned __int128 uint128_t;
+  constexpr size_t mersenne_exp = std::bit_width(t_mersenne_prime);
+  assert(a < t_mersenne_prime && b < t_mersenne_prime);
+
+  uint128_t const product = uint128_t{a} * b;
+  return mod<T, t_mersenne_prime>(static_cast<T>(product & t_mersenne_prime) +
+                                  static_cast<T>(product >> mersenne_exp));
+}
+
+// Return a^exp % prime. The integer a must already be reduced.
+template <typename T, T t_mersenne_prime>
+inline T pow_mod(T a, uint64_t exp) {
+  T result = 1;
+  while (exp > 0) {
+    if (exp & 1) {
+      result = mult_mod<T, t_mersenne_prime>(result, a);
+    }
+    a = mult_mod<T, t_mersenne_prime>(a, a);
+    exp >>= 1;
+  }
+  return result;
+}
 }  // namespace alx::mersenne
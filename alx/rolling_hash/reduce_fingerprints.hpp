@@ -11,9 +11,10 @@
 #include <chrono>
 #include <cmath>
 #include <memory>
+#include <numeric>
 #include <vector>
 
-#include "lce/lce_naive_wordwise.hpp"
+#include "lce/lce_naive_simd.hpp"
 #include "rolling_hash/string_synchronizing_set.hpp"
 
 #ifdef ALX_BENCHMARK_INTERNAL
@@ -28,12 +29,13 @@
 
 namespace alx::lce {
 
+// The 3tau-infixes are compared for the i-th and j-th position in the sss.
 template <typename sss_type>
-bool leq_three_tau(uint8_t const* text, size_t text_size, size_t text_pos_i,
-                   size_t text_pos_j, sss_type const& sync_set);
+bool leq_three_tau(uint8_t const* text, size_t text_size, size_t i, size_t j,
+                   sss_type const& sync_set);
 template <typename sss_type>
-bool eq_three_tau(uint8_t const* text, size_t text_size, size_t text_pos_i,
-                  size_t text_pos_j, sss_type const& sync_set);
+bool eq_three_tau(uint8_t const* text, size_t text_size, size_t i, size_t j,
+                  sss_type const& sync_set);
 
 template <typename sss_type>
 std::vector<typename sss_type::index_type> reduce_fps_3tau_lexicographic(
@@ -44,17 +46,22 @@ std::vector<typename sss_type::index_type> reduce_fps_3tau_lexicographic(
   __extension__ typedef unsigned __int128 uint128_t;
   std::vector<index_type> const& sss = sync_set.get_sss();
 
-  // sort sss-pos by 3tau-infix
-  std::vector<index_type> sss_sorted = sss;
+  // sort sss-indexes by 3tau-infix. We sort the indexes instead of the
+  // positions, so that the run information can be accessed in constant time.
+  std::vector<index_type> sss_sorted(sss.size());
+  std::iota(sss_sorted.begin(), sss_sorted.end(), 0);
   ips4o::parallel::sort(
       sss_sorted.begin(), sss_sorted.end(),
-      [&text, &text_size, &sync_set](index_type lhs, index_type rhs) {
-        if (lhs == rhs) {
+      [&text, &text_size, &sss, &sync_set](index_type lhs_idx,
+                                           index_type rhs_idx) {
+        if (lhs_idx == rhs_idx) {
           return false;
         }
+        size_t const lhs = sss[lhs_idx];
+        size_t const rhs = sss[rhs_idx];
         assert(lhs != rhs);
-        size_t lce = lce_naive_wordwise<uint8_t>::lce_up_to(text, text_size,
-                                                            lhs, rhs, 3 * tau);
+        size_t lce = lce_naive_simd<uint8_t>::lce_up_to(text, text_size, lhs,
+                                                        rhs, 3 * tau);
 
         if (std::max(lhs, rhs) + lce == text_size) {
           return lhs > rhs;
@@ -62,10 +69,9 @@ std::vector<typename sss_type::index_type> reduce_fps_3tau_lexicographic(
         if (text[lhs + lce] != text[rhs + lce]) {
           return text[lhs + lce] < text[rhs + lce];
         }
-        if (sync_set.get_run_info(lhs) != sync_set.get_run_info(rhs)) {
-          return sync_set.get_run_info(lhs) < sync_set.get_run_info(rhs);
-        }
-        return false;
+        int64_t const lhs_run_info = sync_set.get_run_info_at(lhs_idx);
+        int64_t const rhs_run_info = sync_set.get_run_info_at(rhs_idx);
+        return lhs_run_info < rhs_run_info;
       });
 
   for (size_t idx = 1; idx < sss_sorted.size(); ++idx) {
@@ -149,39 +155,39 @@ std::vector<typename sss_type::index_type> reduce_fps_3tau_lexicographic(
     }
   }
 
-  // Sort tuples by pos
-  ips4o::parallel::sort(
-      rank_tuples.begin(), rank_tuples.end(),
-      [](auto lhs, auto rhs) { return lhs.index < rhs.index; });
-
-  // Overwrite
+  // Overwrite. The tuples store sss-indexes, so they need no sorting.
   std::vector<index_type> fps_reduced(sss.size());
+#pragma omp parallel for
   for (size_t i = 0; i < rank_tuples.size(); ++i) {
-    fps_reduced[i] = rank_tuples[i].rank;
+    fps_reduced[rank_tuples[i].index] = rank_tuples[i].rank;
   }
   // fps.push_back(0) // If using SAIS
   return fps_reduced;
 }
 
 template <typename sss_type>
-bool leq_three_tau(uint8_t const* text, size_t text_size, size_t text_pos_i,
-                   size_t text_pos_j, sss_type const& sync_set) {
+bool leq_three_tau(uint8_t const* text, size_t text_size, size_t i, size_t j,
+                   sss_type const& sync_set) {
   constexpr size_t tau = sync_set.tau;
+  size_t const text_pos_i = sync_set[i];
+  size_t const text_pos_j = sync_set[j];
   size_t const max_length = std::min(
       {text_size - text_pos_i, text_size - text_pos_j, 3 * sync_set.tau});
-  size_t text_lce = lce_naive_wordwise<uint8_t>::lce_up_to(
+  size_t text_lce = lce_naive_simd<uint8_t>::lce_up_to(
       text, text_size, text_pos_i, text_pos_j, 3 * tau);
   return (text_lce < max_length &&
           text[text_pos_i + text_lce] < text[text_pos_j + text_lce]) ||
-         (text_lce == max_length && sync_set.get_run_info(text_pos_i) <=
-                                        sync_set.get_run_info(text_pos_j));
+         (text_lce == max_length &&
+          sync_set.get_run_info_at(i) <= sync_set.get_run_info_at(j));
 }
 
 template <typename sss_type>
-bool eq_three_tau(uint8_t const* text, size_t text_size, size_t text_pos_i,
-                  size_t text_pos_j, sss_type const& sync_set) {
+bool eq_three_tau(uint8_t const* text, size_t text_size, size_t i, size_t j,
+                  sss_type const& sync_set) {
+  size_t const text_pos_i = sync_set[i];
+  size_t const text_pos_j = sync_set[j];
   assert(text_pos_i != text_pos_j);
-  size_t lce = lce_naive_wordwise<uint8_t>::lce_up_to(
+  size_t lce = lce_naive_simd<uint8_t>::lce_up_to(
       text, text_size, text_pos_i, text_pos_j, 3 * sync_set.tau);
 
   if (std::max(text_pos_i, text_pos_j) + lce == text_size) {
@@ -190,7 +196,7 @@ bool eq_three_tau(uint8_t const* text, size_t text_size, size_t text_pos_i,
   if (text[text_pos_i + lce] != text[text_pos_j + lce]) {
     return false;
   }
-  if (sync_set.get_run_info(text_pos_i) != sync_set.get_run_info(text_pos_j)) {
+  if (sync_set.get_run_info_at(i) != sync_set.get_run_info_at(j)) {
     return false;
   }
   return true;
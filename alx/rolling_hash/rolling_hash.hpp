@@ -22,6 +22,8 @@ __extension__ typedef unsigned __int128 uint128_t;
 template <size_t t_prime_exp = 107>
 class rk_prime {
  public:
+  typedef uint128_t fp_type;
+
   rk_prime() : rk_prime(1, 0) {
   }
 
@@ -121,4 +123,98 @@ class rk_prime {
     }
   }
 };
-}  // namespace alx::rolling_hash
\ No newline at end of file
+
+// Rolling hash modulo the mersenne prime 2^61-1 with 64 bit fingerprints. It
+// computes the same fingerprints as rk_prime<61>, but instead of the 1 MiB
+// table over all pairs of characters it only stores -c*base^tau for each
+// character c (2 KiB), so that several instances fit into the L1 cache. The
+// character that is rolled in is added as is.
+class rk_compact {
+ public:
+  typedef uint64_t fp_type;
+
+  rk_compact() : rk_compact(1, 0) {
+  }
+
+  rk_compact(uint64_t tau, uint64_t base = 0) : m_tau(tau), m_fp(0) {
+    m_base = (base == 0) ? random64(257, m_prime - 1) : base;
+    assert(m_base < m_prime);
+
+    fill_influence_table();
+  }
+
+  // Roll the window by specifying the character that is rolled in the window.
+  inline uint64_t roll_in(unsigned char in) {
+    return roll(0, in);
+  }
+
+  // Roll the window by specifying the character that is rolled out of the
+  // window.
+  inline uint64_t roll_out(unsigned char out) {
+    return roll(out, 0);
+  }
+
+  // Roll the window by specifying the character that is rolled out of the
+  // window and the character that is rolled in the window.
+  inline uint64_t roll(unsigned char out, unsigned char in) {
+    uint128_t const product = uint128_t{m_fp} * m_base;
+    // Both halves are below 2^61, the table entry is below the prime, so the
+    // sum fits into 64 bits.
+    uint64_t const sum = (static_cast<uint64_t>(product) & m_prime) +
+                         static_cast<uint64_t>(product >> m_prime_exp) +
+                         m_out_influence[out] + in;
+    m_fp = mersenne::mod<uint64_t, m_prime>(sum);
+    return m_fp;
+  }
+
+  // Return the prime number used for the rolling hash function.
+  inline constexpr uint64_t get_prime() const {
+    return m_prime;
+  }
+
+  // Return the prime exponent used for the rolling hash function.
+  inline constexpr uint64_t get_prime_exp() const {
+    return m_prime_exp;
+  }
+
+  // Return the fingerprint of the current window.
+  inline uint64_t get_fp() const {
+    return m_fp;
+  }
+
+  // Return the base of rolling hash function.
+  inline uint64_t get_base() const {
+    return m_base;
+  }
+
+ private:
+  static constexpr size_t m_prime_exp = 61;
+  static constexpr uint64_t m_prime = (uint64_t{1} << m_prime_exp) - 1;
+  uint64_t m_tau;
+  uint64_t m_fp;
+
+  uint64_t m_base;
+  uint64_t m_out_influence[256];
+
+  // Return a random number that will be used as the base.
+  inline static uint64_t random64(uint64_t min, uint64_t max) {
+    static std::mt19937_64 g = std::mt19937_64(std::random_device()());
+    return (std::uniform_int_distribution<uint64_t>(min, max))(g);
+  }
+
+  // Fill up the table needed for fast rolling.
+  void fill_influence_table() {
+    const uint64_t base_pow_tau_mod_prime =
+        modular::pow_mod<uint64_t>(m_base, m_tau, m_prime);
+    const uint64_t minus_base_pow_tau_mod_prime =
+        mersenne::additive_inverse_mod<uint64_t, m_prime>(
+            base_pow_tau_mod_prime);
+
+    m_out_influence[0] = 0;
+    for (size_t i = 1; i < 256; ++i) {
+      m_out_influence[i] = mersenne::add_mod<uint64_t, m_prime>(
+          m_out_influence[i - 1], minus_base_pow_tau_mod_prime);
+    }
+  }
+};
+}  // namespace alx::rolling_hash
@@ -0,0 +1,147 @@
+/*******************************************************************************
+ * alx/rolling_hash/sliding_window_min.hpp
+ *
+ * Copyright (C) 2026 Alexander Herlez <alexander.herlez@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#include <assert.h>
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace alx::rolling_hash {
+
+// Leftmost minimum of the values in a window [begin, begin + width) that
+// slides to the right, in O(1) amortized time per position.
+//
+// As long as the minimum stays in the window, it is only compared with the
+// values that enter the window. Once it leaves the window, the new minimum is
+// found in constant time as in the algorithm of van Herk and Gil-Werman: The
+// window is covered by a block, of which we know the minima of all suffixes,
+// and the part behind the block, of which we keep the minimum. A new block
+// starts at begin once begin leaves the block, which needs width steps and
+// happens at most once every width positions.
+//
+// Unlike with a monotone queue, the common case needs a single comparison per
+// position, which is predictable for random fingerprints.
+template <typename T>
+class sliding_window_min {
+ public:
+  sliding_window_min(uint64_t const width)
+      : m_width(width), m_block_begin(0), m_end(0), m_suffix_min(width) {
+    assert(width > 0);
+  }
+
+  // Return the leftmost position of the minimum of value(pos) for pos in
+  // [begin, begin + width). Every value is read from a position in the window.
+  // If begin is smaller than in the previous call, the window is rebuilt.
+  template <typename F>
+  uint64_t min_pos(uint64_t const begin, F const& value) {
+    if (begin < m_block_begin || begin >= m_end ||
+        begin + m_width < m_end) {
+      new_block(begin, value);
+      return m_min.pos;
+    }
+    // Add the positions that enter the window. The state is kept in local
+    // variables, as value may read memory that aliases the members.
+    uint64_t end = m_end;
+    entry min = m_min;
+    for (; end < begin + m_width; ++end) {
+      T const cur_value = value(end);
+      if (cur_value < min.value) {
+        min = {end, cur_value};
+      }
+    }
+    m_end = end;
+    m_min = min;
+    // The minimum left the window.
+    if (min.pos < begin) {
+      m_min = block_min(begin, value);
+    }
+    return m_min.pos;
+  }
+
+  // Return the same as min_pos, but without comparing the values that entered
+  // the window since the previous call. This is cheaper for callers that keep
+  // the minimum themselves and only ask for a new one once it left the window.
+  template <typename F>
+  uint64_t next_min_pos(uint64_t const begin, F const& value) {
+    if (begin < m_block_begin || begin >= m_end ||
+        begin + m_width < m_end) {
+      new_block(begin, value);
+      return m_min.pos;
+    }
+    m_end = begin + m_width;
+    m_min = block_min(begin, value);
+    return m_min.pos;
+  }
+
+ private:
+  struct entry {
+    uint64_t pos;
+    T value;
+  };
+
+  // Return the minimum of the window [begin, m_end) from the minima of the
+  // block suffixes and of the positions behind the block.
+  template <typename F>
+  entry block_min(uint64_t const begin, F const& value) {
+    uint64_t const block_end = m_block_begin + m_width;
+    if (begin >= block_end) {
+      new_block(begin, value);
+      return m_min;
+    }
+    uint64_t const suffix_min_pos = m_suffix_min[begin - m_block_begin];
+    entry const suffix_min = {suffix_min_pos, value(suffix_min_pos)};
+    if (m_end == block_end) {
+      return suffix_min;
+    }
+    // Update the minimum of the positions behind the block.
+    uint64_t behind_end = m_behind_end;
+    entry behind_min = m_behind_min;
+    for (; behind_end < m_end; ++behind_end) {
+      T const cur_value = value(behind_end);
+      if (behind_end == block_end || cur_value < behind_min.value) {
+        behind_min = {behind_end, cur_value};
+      }
+    }
+    m_behind_end = behind_end;
+    m_behind_min = behind_min;
+    return (behind_min.value < suffix_min.value) ? behind_min : suffix_min;
+  }
+
+  // Start a new block at begin with the minima of its suffixes.
+  template <typename F>
+  void new_block(uint64_t const begin, F const& value) {
+    m_block_begin = begin;
+    m_end = begin + m_width;
+    m_behind_end = m_end;
+    entry min = {m_end - 1, value(m_end - 1)};
+    m_suffix_min[m_width - 1] = min.pos;
+    for (uint64_t k = m_width - 1; k-- > 0;) {
+      T const cur_value = value(begin + k);
+      if (cur_value <= min.value) {
+        min = {begin + k, cur_value};
+      }
+      m_suffix_min[k] = min.pos;
+    }
+    m_min = min;
+  }
+
+  uint64_t const m_width;
+  uint64_t m_block_begin;
+  // The window ends at m_end.
+  uint64_t m_end;
+  entry m_min;
+  // Minimum of [m_block_begin + m_width, m_behind_end), which is only updated
+  // when it is needed.
+  uint64_t m_behind_end;
+  entry m_behind_min;
+
+  std::vector<uint64_t> m_suffix_min;
+};  // class sliding_window_min
+}  // namespace alx::rolling_hash
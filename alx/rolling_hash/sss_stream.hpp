@@ -0,0 +1,341 @@
+/*******************************************************************************
+ * alx/rolling_hash/sss_stream.hpp
+ *
+ * Copyright (C) 2026 Alexander Herlez <alexander.herlez@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#include <assert.h>
+#include <omp.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+
+#include "string_synchronizing_set.hpp"
+
+namespace alx::rolling_hash {
+
+// Compute the string synchronizing set of a text that does not fit into main
+// memory. The text is read from a file descriptor chunk by chunk. For the
+// positions [chunk_begin, chunk_end), the window
+// text[chunk_begin - 1..chunk_end + 3 * tau] is read, so consecutive windows
+// overlap by 3 * tau + 2 bytes. The positions of a chunk are computed in
+// parallel with the functions of sss and passed to a sink in increasing order,
+// optionally together with the fingerprints of their 3tau-windows. Only the
+// window and the positions of one chunk are kept in memory. Positions and
+// fingerprints are the same as those of sss without t_compact_fps. The run
+// information is not computed.
+//
+// As in sss, the text is first read without detecting runs. If the sss
+// inflates, the sink is cleared and the text is read again with run detection.
+template <typename t_index = uint32_t, uint64_t t_tau = 1024,
+          typename t_rolling_hash = rk_prime<>>
+class sss_stream {
+ public:
+  typedef t_index index_type;
+  static constexpr uint64_t tau = t_tau;
+  typedef sss<t_index, t_tau, t_rolling_hash> sss_type;
+  typedef typename sss_type::uint128_t uint128_t;
+
+  sss_stream(int fd, size_t size, size_t chunk_size = size_t{1} << 28)
+      : m_fd(fd),
+        m_size(size),
+        m_chunk_size(std::clamp<size_t>(chunk_size, t_tau, size)),
+        m_runs_detected(false) {
+    assert(size > 5 * t_tau);
+  }
+
+  // Pass the positions of the sss to sink.push_back(pos, fp), where fp is the
+  // fingerprint of the 3tau-window at pos if calculate_fps is set, and 0
+  // otherwise. Return false if the text could not be read.
+  template <typename t_sink>
+  bool build(t_sink& sink, bool calculate_fps = false) {
+    m_runs_detected = false;
+    sink.clear();
+    read_status status = read_text(sink, calculate_fps);
+    if (status == read_status::runs_detected) {
+      m_runs_detected = true;
+      sink.clear();
+      status = read_text(sink, calculate_fps);
+    }
+    if (status == read_status::read_error) {
+      return false;
+    }
+    if (m_runs_detected) {
+      // sentinel needed for text with runs
+      sink.push_back(m_size - 2 * t_tau + 1, calculate_fps ? 1 : 0);
+    }
+    return true;
+  }
+
+  bool has_runs() const {
+    return m_runs_detected;
+  }
+
+ private:
+  enum class read_status { complete, runs_detected, read_error };
+
+  // A window of the text that is accessed with absolute text positions.
+  struct window_text {
+    uint8_t const* data;
+    size_t offset;
+
+    uint8_t operator[](size_t const pos) const {
+      assert(pos >= offset);
+      return data[pos - offset];
+    }
+  };
+
+  template <typename t_sink>
+  read_status read_text(t_sink& sink, bool const calculate_fps) {
+    size_t const sss_end = m_size - 2 * t_tau + 1;
+    size_t const max_sss_size = m_size * 4 / t_tau;
+    std::atomic<size_t> sss_size_found{0};
+
+    std::vector<uint8_t> window(m_chunk_size + 3 * t_tau + 2);
+    std::vector<std::vector<t_index>> sss_part(omp_get_max_threads());
+    std::vector<std::vector<uint128_t>> fps_part(omp_get_max_threads());
+
+    // The last position is passed to the sink once the next one is known, as
+    // its fingerprint may need the distance to it.
+    bool has_last = false;
+    size_t last_pos = 0;
+    uint128_t last_fp = 0;
+
+    for (size_t chunk_begin = 0; chunk_begin < sss_end;
+         chunk_begin += m_chunk_size) {
+      size_t const chunk_end = std::min(chunk_begin + m_chunk_size, sss_end);
+      size_t const window_begin = (chunk_begin == 0) ? 0 : chunk_begin - 1;
+      size_t const window_end = chunk_end + 3 * t_tau + 1;
+      if (!read_window(window, window_begin, window_end)) {
+        return read_status::read_error;
+      }
+      window_text const text{window.data(), window_begin};
+      // Runs may only be extended to the right within the window.
+      size_t const max_run_end = std::min(window_end - 1, m_size) - 1;
+
+#pragma omp parallel
+      {
+        const int t = omp_get_thread_num();
+        const int nt = omp_get_num_threads();
+        const size_t slice_size = (chunk_end - chunk_begin) / nt;
+
+        const size_t begin = chunk_begin + t * slice_size;
+        const size_t end =
+            (t < nt - 1) ? chunk_begin + (t + 1) * slice_size : chunk_end;
+
+        sss_part[t].clear();
+        if (!m_runs_detected) {
+          m_sss.fill_synchronizing_set(text, begin, end, sss_part[t],
+                                       sss_size_found, max_sss_size);
+        } else {
+          std::vector<std::pair<t_index, int64_t>> run_info;
+          std::vector<std::pair<t_index, t_index>> qset = m_sss.calculate_q(
+              text, m_size, begin, end, run_info, max_run_end);
+          sss_part[t] = m_sss.fill_synchronizing_set_runs(text, begin, end,
+                                                          qset);
+        }
+        if (calculate_fps && sss_size_found <= max_sss_size) {
+          fill_fingerprints(text, sss_part[t], fps_part[t]);
+        }
+      }
+      if (sss_size_found > max_sss_size) {
+        return read_status::runs_detected;
+      }
+
+      for (size_t t = 0; t < sss_part.size(); ++t) {
+        for (size_t k = 0; k < sss_part[t].size(); ++k) {
+          size_t const pos = sss_part[t][k];
+          if (has_last) {
+            sink.push_back(last_pos, last_fp + run_distance(last_pos, pos));
+          }
+          has_last = true;
+          last_pos = pos;
+          last_fp = calculate_fps ? fps_part[t][k] : 0;
+        }
+      }
+    }
+    if (has_last) {
+      sink.push_back(last_pos, last_fp);
+    }
+    return read_status::complete;
+  }
+
+  // Read text[begin..end) into window. Positions behind the text are 0.
+  bool read_window(std::vector<uint8_t>& window, size_t const begin,
+                   size_t const end) const {
+    size_t const read_end = std::min(end, m_size);
+    size_t bytes_read = 0;
+    while (begin + bytes_read < read_end) {
+      ssize_t const result =
+          pread(m_fd, window.data() + bytes_read,
+                read_end - begin - bytes_read, begin + bytes_read);
+      if (result < 0 && errno == EINTR) {
+        continue;
+      }
+      if (result <= 0) {
+        return false;
+      }
+      bytes_read += result;
+    }
+    std::fill(window.begin() + bytes_read, window.begin() + (end - begin), 0);
+    return true;
+  }
+
+  // Calculate the fingerprints of the 3tau-windows at the given positions. The
+  // rolling hash is rolled over the gaps.
+  void fill_fingerprints(window_text const& text,
+                         std::vector<t_index> const& positions,
+                         std::vector<uint128_t>& fps) const {
+    fps.resize(positions.size());
+    if (positions.empty()) {
+      return;
+    }
+    t_rolling_hash rk3(3 * t_tau, 296819);
+    size_t pos = positions.front();
+    for (size_t j = 0; j < 3 * t_tau; ++j) {
+      rk3.roll_in(text[pos + j]);
+    }
+    for (size_t k = 0; k < positions.size(); ++k) {
+      for (; pos < positions[k]; ++pos) {
+        rk3.roll(text[pos], text[pos + 3 * t_tau]);
+      }
+      fps[k] = rk3.get_fp();
+    }
+  }
+
+  // The distance to the next position is added to the fingerprints of
+  // positions that precede a run, see sss.
+  uint128_t run_distance(size_t const pos, size_t const next_pos) const {
+    size_t const distance = next_pos - pos;
+    if (!m_runs_detected || distance <= t_tau) {
+      return 0;
+    }
+    // we only have 20 empty bits in fingerprint
+    assert(distance < (size_t{1} << 20));
+    return uint128_t{distance} << 107;
+  }
+
+  int const m_fd;
+  size_t const m_size;
+  size_t const m_chunk_size;
+  bool m_runs_detected;
+  // Only used for its functions that fill the sss of a slice.
+  sss_type const m_sss;
+};  // class sss_stream
+
+// Keep the positions and fingerprints in memory.
+template <typename t_index>
+struct sss_vector_sink {
+  __extension__ typedef unsigned __int128 uint128_t;
+
+  void push_back(size_t const pos, uint128_t const fp) {
+    sss.push_back(pos);
+    fps.push_back(fp);
+  }
+
+  void clear() {
+    sss.clear();
+    fps.clear();
+  }
+
+  std::vector<t_index> sss;
+  std::vector<uint128_t> fps;
+};
+
+// Append the positions (and optionally the fingerprints) to files in the
+// format of util::write_vector.
+template <typename t_index>
+class sss_file_sink {
+ public:
+  __extension__ typedef unsigned __int128 uint128_t;
+
+  sss_file_sink(std::filesystem::path const& sss_path,
+                std::filesystem::path const& fps_path = {})
+      : m_sss_file(std::fopen(sss_path.c_str(), "wb")),
+        m_fps_file(fps_path.empty() ? nullptr
+                                    : std::fopen(fps_path.c_str(), "wb")),
+        m_good(m_sss_file != nullptr &&
+               (fps_path.empty() || m_fps_file != nullptr)) {
+    m_sss_buffer.reserve(m_buffer_size);
+    m_fps_buffer.reserve(m_fps_file ? m_buffer_size : 0);
+  }
+
+  sss_file_sink(sss_file_sink const&) = delete;
+  sss_file_sink& operator=(sss_file_sink const&) = delete;
+
+  ~sss_file_sink() {
+    close();
+  }
+
+  void push_back(size_t const pos, uint128_t const fp) {
+    m_sss_buffer.push_back(pos);
+    if (m_fps_file) {
+      m_fps_buffer.push_back(fp);
+    }
+    if (m_sss_buffer.size() == m_buffer_size) {
+      flush();
+    }
+  }
+
+  void clear() {
+    m_sss_buffer.clear();
+    m_fps_buffer.clear();
+    for (std::FILE* file : {m_sss_file, m_fps_file}) {
+      if (file) {
+        m_good &= std::fflush(file) == 0 && ftruncate(fileno(file), 0) == 0;
+        std::rewind(file);
+      }
+    }
+  }
+
+  // Write the buffered positions and close the files. Return whether all
+  // positions were written.
+  bool close() {
+    flush();
+    for (std::FILE** file : {&m_sss_file, &m_fps_file}) {
+      if (*file) {
+        m_good &= std::fclose(*file) == 0;
+        *file = nullptr;
+      }
+    }
+    return m_good;
+  }
+
+  bool good() const {
+    return m_good;
+  }
+
+ private:
+  void flush() {
+    if (m_sss_file) {
+      m_good &= std::fwrite(m_sss_buffer.data(), sizeof(t_index),
+                            m_sss_buffer.size(),
+                            m_sss_file) == m_sss_buffer.size();
+    }
+    if (m_fps_file) {
+      m_good &= std::fwrite(m_fps_buffer.data(), sizeof(uint128_t),
+                            m_fps_buffer.size(),
+                            m_fps_file) == m_fps_buffer.size();
+    }
+    m_sss_buffer.clear();
+    m_fps_buffer.clear();
+  }
+
+  static constexpr size_t m_buffer_size = size_t{1} << 20;
+  std::FILE* m_sss_file;
+  std::FILE* m_fps_file;
+  bool m_good;
+  std::vector<t_index> m_sss_buffer;
+  std::vector<uint128_t> m_fps_buffer;
+};
+}  // namespace alx::rolling_hash
+/******************************************************************************/
@@ -9,20 +9,39 @@
 #pragma once
 
 #include <omp.h>
-#include <parallel_hashmap/phmap.h>
 
-#include <mutex>
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <type_traits>
 
 #include "ring_buffer.hpp"
 #include "rolling_hash.hpp"
+#include "sliding_window_min.hpp"
 namespace alx::rolling_hash {
 
-template <typename t_index = uint32_t, uint64_t t_tau = 1024>
+// The rolling hash is used for the fingerprints of the tau- and 3tau-windows.
+// rk_compact is faster and needs less cache than rk_prime, but the stored
+// fingerprints of the 3tau-windows only have 61 bits.
+//
+// By default, the fingerprints of the 3tau-windows are stored with 128 bits,
+// and the distance to the next position, if it is larger than tau (i.e., the
+// position precedes a run), is added at bit 107. With t_compact_fps, they are
+// stored with 64 bits in the domain of 2^61-1. The rare run distances are kept
+// sorted by sss-index in a separate vector, and the fingerprint of a position
+// that precedes a run is replaced by an id of its fingerprint and distance,
+// which has the highest bit set. Either way, two stored fingerprints are equal
+// iff the 3tau-windows and the run distances are (w.h.p.) equal.
+template <typename t_index = uint32_t, uint64_t t_tau = 1024,
+          typename t_rolling_hash = rk_prime<>, bool t_compact_fps = false>
 class sss {
  public:
   typedef t_index index_type;
   static constexpr uint64_t tau = t_tau;
   __extension__ typedef unsigned __int128 uint128_t;
+  typedef typename t_rolling_hash::fp_type fp_type;
+  typedef std::conditional_t<t_compact_fps, uint64_t, uint128_t>
+      stored_fp_type;
 
   sss() : m_fps_calculated(false) {
   }
@@ -32,7 +51,16 @@ class sss {
       : m_fps_calculated(calculate_fps) {
     assert(size > 5 * t_tau);
     std::vector<std::vector<t_index>> sss_part(omp_get_max_threads());
-    std::vector<std::vector<uint128_t>> fps_part(omp_get_max_threads());
+    std::vector<std::vector<std::pair<t_index, int64_t>>> run_info_part(
+        omp_get_max_threads());
+
+    // If the text contains long runs, the sss inflates. We then use an
+    // algorithm which detects runs. The threads count the positions they find,
+    // and as soon as there are too many, they all switch to this algorithm
+    // instead of finishing the first pass. Slices without runs keep the
+    // result of the first pass.
+    size_t const max_sss_size = size * 4 / t_tau;
+    std::atomic<size_t> sss_size_found{0};
 #pragma omp parallel
     {
       const size_t sss_end = size - 2 * t_tau + 1;
@@ -44,9 +72,18 @@ class sss {
       const size_t begin = t * slice_size;
       const size_t end = (t < nt - 1) ? (t + 1) * slice_size : sss_end;
 
-      std::tie(sss_part[t], fps_part[t]) =
-          fill_synchronizing_set(text, begin, end);
+      bool const complete = fill_synchronizing_set(
+          text, begin, end, sss_part[t], sss_size_found, max_sss_size);
+#pragma omp barrier
+      if (sss_size_found > max_sss_size) {
+        std::vector<std::pair<t_index, t_index>> qset =
+            calculate_q(text, size, begin, end, run_info_part[t], size - 1);
+        if (!complete || !qset.empty()) {
+          sss_part[t] = fill_synchronizing_set_runs(text, begin, end, qset);
+        }
+      }
     }
+    m_runs_detected = sss_size_found > max_sss_size;
 
     // Merge SSS parts
     std::vector<size_t> write_pos{0};
@@ -54,108 +91,92 @@ class sss {
       write_pos.push_back(write_pos.back() + part.size());
     }
     size_t sss_size = write_pos.back();
-    m_runs_detected = sss_size > size * 4 / t_tau;
-
-    // If the text contains long runs, the sss inflates. We the then use a
-    // algorithm which detects runs.
     if (m_runs_detected) {
-#pragma omp parallel
-      {
-        const size_t sss_end = size - 2 * t_tau + 1;
-
-        const int t = omp_get_thread_num();
-        const int nt = omp_get_num_threads();
-        const size_t slice_size = sss_end / nt;
-
-        const size_t begin = t * slice_size;
-        const size_t end = (t < nt - 1) ? (t + 1) * slice_size : sss_end;
-        sss_part[t] = std::vector<t_index>{};
-        std::tie(sss_part[t], fps_part[t]) =
-            fill_synchronizing_set_runs(text, size, begin, end);
-      }
-      write_pos = {0};
-      for (auto& part : sss_part) {
-        write_pos.push_back(write_pos.back() + part.size());
-      }
-      sss_size = write_pos.back() + 1;  //+1 for sentinel
+      sss_size += 1;  //+1 for sentinel
     }
 
     m_sss.resize(sss_size);
-    if (m_fps_calculated) {
-      m_fps.resize(sss_size);
-    }
-#pragma omp parallel
-    {
-      const int t = omp_get_thread_num();
+#pragma omp parallel for
+    for (size_t t = 0; t < sss_part.size(); ++t) {
       std::copy(sss_part[t].begin(), sss_part[t].end(),
                 m_sss.begin() + write_pos[t]);
-      if (m_fps_calculated) {
-        std::copy(fps_part[t].begin(), fps_part[t].end(),
-                  m_fps.begin() + write_pos[t]);
-#pragma omp barrier
-        // add distance to positions that start periodic area
-        if (m_runs_detected && m_fps_calculated && !fps_part[t].empty() &&
-            write_pos[t] != 0) {
-          size_t i = m_sss[write_pos[t]];
-          size_t prev_i = m_sss[write_pos[t] - 1];
-          size_t distance = i - prev_i;
-          assert(distance < (size_t{1} << 20));
-          if (distance > t_tau) {
-            m_fps[write_pos[t] - 1] += (uint128_t{distance} << 107);
-          }
-        }
-      }
+      sss_part[t] = std::vector<t_index>{};
     }
     if (m_runs_detected) {
       m_sss.back() =
           size - 2 * t_tau + 1;  // sentinel needed for text with runs
-      if (m_fps_calculated) {
+    }
+
+    // The fingerprints are calculated after the sss is merged. This way, they
+    // are written to m_fps directly and not copied from parts of each thread.
+    if (m_fps_calculated) {
+      m_fps.resize(sss_size);
+      std::vector<std::vector<std::pair<t_index, t_index>>> run_distance_part(
+          sss_part.size());
+#pragma omp parallel for
+      for (size_t t = 0; t < sss_part.size(); ++t) {
+        fill_fingerprints(text, write_pos[t], write_pos[t + 1],
+                          run_distance_part[t]);
+      }
+      if (m_runs_detected) {
         m_fps.back() = 1;
       }
+      if constexpr (t_compact_fps) {
+        set_run_distances(run_distance_part);
+      }
+    }
+    if (m_runs_detected) {
+      set_run_info(run_info_part);
     }
   }
 
-  template <typename t_char_type>
-  std::pair<std::vector<t_index>, std::vector<uint128_t>>
-  fill_synchronizing_set(t_char_type const* text, const size_t from,
-                         const size_t to) const {
+  // The following functions read the text with text[pos] for absolute text
+  // positions pos, where text is a pointer or a view of a window of the text.
+  // For [from, to), they read at most text[from - 1..to + 3 * tau].
+
+  // Fill the sss of [from, to) without detecting runs. The number of positions
+  // found is added to sss_size_found every tau positions. Return false early
+  // if it exceeds max_sss_size, as the text then contains runs.
+  template <typename t_text>
+  bool fill_synchronizing_set(t_text const& text, const size_t from,
+                              const size_t to, std::vector<t_index>& sss,
+                              std::atomic<size_t>& sss_size_found,
+                              size_t const max_sss_size) const {
     // calculate SSS
-    std::vector<t_index> sss;
-    std::vector<uint128_t> fps;
-
-    rk_prime rk(t_tau, 296819);
-    rk_prime rk3(3 * t_tau, 296819);
+    size_t sss_size_reported = 0;
 
+    t_rolling_hash rk(t_tau, 296819);
     for (size_t i = 0; i < t_tau; ++i) {
       rk.roll_in(text[from + i]);
     }
-    for (size_t i = 0; i < 3 * t_tau; ++i) {
-      rk3.roll_in(text[from + i]);
-    }
 
-    ring_buffer<uint128_t> fingerprints(4 * t_tau);
+    ring_buffer<fp_type> fingerprints(4 * t_tau);
     fingerprints.resize(from);
     fingerprints.push_back(rk.get_fp());
 
-    ring_buffer<uint128_t> fingerprints3(4 * t_tau);
-    fingerprints3.resize(from);
-    fingerprints3.push_back(rk3.get_fp());
-
-    // Loop:
-    t_index first_min = 0;
+    // Loop: The minimum of the fingerprints in [i, i + tau] is compared with
+    // the fingerprint that enters the range. Only once it leaves the range, the
+    // new minimum is found with a sliding window.
+    sliding_window_min<fp_type> window(t_tau + 1);
+    auto const fingerprint = [&fingerprints](size_t const pos) {
+      return fingerprints[pos];
+    };
+    size_t first_min = from;
     for (size_t i = from; i < to; ++i) {
-      for (size_t j = fingerprints.size(); j <= i + 3 * t_tau; ++j) {
+      if ((i - from) % t_tau == 0) {
+        size_t const found =
+            sss_size_found.fetch_add(sss.size() - sss_size_reported) +
+            sss.size() - sss_size_reported;
+        sss_size_reported = sss.size();
+        if (found > max_sss_size) {
+          return false;
+        }
+      }
+      for (size_t j = fingerprints.size(); j <= i + t_tau; ++j) {
         fingerprints.push_back(rk.roll(text[j - 1], text[j + t_tau - 1]));
-        fingerprints3.push_back(rk3.roll(text[j - 1], text[j + 3 * t_tau - 1]));
       }
-
-      if (first_min == 0 || first_min < i) {
-        first_min = i;
-        for (size_t j = i; j <= i + t_tau; ++j) {
-          if (fingerprints[j] < fingerprints[first_min]) {
-            first_min = j;
-          }
-        }
+      if (i == from || first_min < i) {
+        first_min = window.next_min_pos(i, fingerprint);
       } else if (fingerprints[i + t_tau] < fingerprints[first_min]) {
         first_min = i + t_tau;
       }
@@ -163,21 +184,17 @@ class sss {
       if (fingerprints[first_min] == fingerprints[i] ||
           fingerprints[first_min] == fingerprints[i + t_tau]) {
         sss.push_back(i);
-        if (m_fps_calculated) {
-          fps.push_back(fingerprints3[i]);
-        }
       }
     }
-    return {sss, fps};
+    sss_size_found += sss.size() - sss_size_reported;
+    return true;
   }
-  template <typename t_char_type>
-  std::pair<std::vector<t_index>, std::vector<uint128_t>>
-  fill_synchronizing_set_runs(const t_char_type* text, size_t size,
-                              const size_t from, const size_t to) {
-    // calculate Q
-    std::vector<std::pair<t_index, t_index>> qset =
-        calculate_q(text, size, from, to);
 
+  // Fill the sss of [from, to) without the positions in qset, see calculate_q.
+  template <typename t_text>
+  std::vector<t_index> fill_synchronizing_set_runs(
+      t_text const& text, const size_t from, const size_t to,
+      std::vector<std::pair<t_index, t_index>> qset) const {
     /* PRINT Q
     #pragma omp critical
     {
@@ -197,138 +214,136 @@ class sss {
     // BEGIN
 
     std::vector<t_index> sss;
-    std::vector<uint128_t> fps;
 
-    rk_prime rk(t_tau, 296819);
-    rk_prime rk3(3 * t_tau, 296819);
+    t_rolling_hash rk(t_tau, 296819);
     for (size_t i = 0; i < t_tau; ++i) {
       rk.roll_in(text[from + i]);
     }
-    for (size_t i = 0; i < 3 * t_tau; ++i) {
-      rk3.roll_in(text[from + i]);
-    }
 
-    ring_buffer<uint128_t> fingerprints(4 * t_tau);
+    ring_buffer<fp_type> fingerprints(4 * t_tau);
     fingerprints.resize(from);
     fingerprints.push_back(rk.get_fp());
 
-    ring_buffer<uint128_t> fingerprints3(4 * t_tau);
-    fingerprints3.resize(from);
-    fingerprints3.push_back(rk3.get_fp());
-
-    t_index MIN_UNKNOWN = std::numeric_limits<t_index>::max();
-    t_index first_min = MIN_UNKNOWN;
-    // Loop:
+    // Loop: The minimum of the fingerprints in [i, i + tau] that are not in q
+    // is found with a sliding window. Positions in q get the largest value of
+    // fp_type, which is larger than all fingerprints.
+    constexpr fp_type in_q = std::numeric_limits<fp_type>::max();
+    ring_buffer<fp_type> candidates(4 * t_tau);
+    candidates.resize(from);
+    sliding_window_min<fp_type> window(t_tau + 1);
+    auto const candidate = [&candidates](size_t const pos) {
+      return candidates[pos];
+    };
     for (size_t i = from; i < to; ++i) {
       for (size_t j = fingerprints.size(); j <= i + t_tau; ++j) {
         fingerprints.push_back(rk.roll(text[j - 1], text[j + t_tau - 1]));
-        fingerprints3.push_back(rk3.roll(text[j - 1], text[j + 3 * t_tau - 1]));
       }
-      while (it_q->second < i) {
-        std::advance(it_q, 1);
-      }
-
-      // If then minimum in the current range is not known, we need to find one
-      if (first_min == MIN_UNKNOWN || first_min < i) {
-        auto it_qt = it_q;
-        for (size_t j = i; j <= i + t_tau; ++j) {
-          // advance q pointer
-          if (it_qt->second < j) {
-            std::advance(it_qt, 1);
-          }
-          // don't compare values from q
-          if (it_qt->first <= j) {
-            // first_min = it_qt->second + 1;
-            // j = first_min;
-            j = it_qt->second;
-            continue;
-          }
-          // take first fingerprint not in q
-          if (first_min == MIN_UNKNOWN || first_min < i) {
-            first_min = j;
-          }
-          // compare values that are not in q
-          if (fingerprints[j] < fingerprints[first_min]) {
-            first_min = j;
-          }
-        }
-        // If no minimum exists, we jump to the next position, which may be part
-        // of sss
-        if (first_min == MIN_UNKNOWN || first_min < i) {
-          i = it_qt->second - t_tau;
-          continue;
+      for (size_t j = candidates.size(); j <= i + t_tau; ++j) {
+        while (it_q->second < j) {
+          std::advance(it_q, 1);
         }
+        // don't compare values from q
+        candidates.push_back(it_q->first > j ? fingerprints[j] : in_q);
       }
-      // If the minimum of the range is already known, we only need to compare
-      // with the new fingerprint
-      else if (first_min <= i + t_tau) {
-        auto it_qt = it_q;
-        while (it_qt->second < i + t_tau) {
-          std::advance(it_qt, 1);
-        }
-        if (it_qt->first > i + t_tau &&
-            fingerprints[i + t_tau] < fingerprints[first_min]) {
-          first_min = i + t_tau;
-        }
+      size_t const first_min = window.min_pos(i, candidate);
+      // If all positions of the range are in q, i is not part of the sss.
+      if (candidates[first_min] == in_q) {
+        continue;
       }
+
       // maybe_add(i);
       if (fingerprints[first_min] == fingerprints[i] ||
           fingerprints[first_min] == fingerprints[i + t_tau]) {
         sss.push_back(i);
-        if (m_fps_calculated) {
-          fps.push_back(fingerprints3[i]);
-          // add distance to positions that start periodic area
-          if (sss.size() > 1) {
-            size_t prev_i = sss[sss.size() - 2];
-            size_t distance = i - prev_i;
-            // we only have 20 empty bits in fingerprint
-            assert(distance < (size_t{1} << 20));
-            if (distance > t_tau) {
-              fps[sss.size() - 2] += (uint128_t{distance} << 107);
-            }
+      }
+    }
+    return sss;
+  }
+
+  // Write the fingerprints of the 3tau-windows at the positions
+  // m_sss[begin..end) to m_fps. The rolling hash is rolled over the gaps. With
+  // t_compact_fps, the run distances are appended to run_distances.
+  template <typename t_char_type>
+  void fill_fingerprints(
+      t_char_type const* text, size_t const begin, size_t const end,
+      std::vector<std::pair<t_index, t_index>>& run_distances) {
+    if (begin == end) {
+      return;
+    }
+    // The sentinel is not part of the sss.
+    size_t const num_positions = m_sss.size() - (m_runs_detected ? 1 : 0);
+    t_rolling_hash rk3(3 * t_tau, 296819);
+    size_t pos = m_sss[begin];
+    for (size_t j = 0; j < 3 * t_tau; ++j) {
+      rk3.roll_in(text[pos + j]);
+    }
+    for (size_t k = begin; k < end; ++k) {
+      for (; pos < m_sss[k]; ++pos) {
+        rk3.roll(text[pos], text[pos + 3 * t_tau]);
+      }
+      if constexpr (t_compact_fps) {
+        m_fps[k] = mersenne::mod<uint128_t, m_compact_prime>(rk3.get_fp());
+      } else {
+        m_fps[k] = rk3.get_fp();
+      }
+      // add distance to positions that start periodic area
+      if (m_runs_detected && k + 1 < num_positions) {
+        size_t const distance = m_sss[k + 1] - m_sss[k];
+        if constexpr (t_compact_fps) {
+          // The distance is smaller than the text, so it fits into t_index.
+          if (distance > t_tau) {
+            run_distances.emplace_back(k, static_cast<t_index>(distance));
+          }
+        } else {
+          // we only have 20 empty bits in fingerprint
+          assert(distance < (size_t{1} << 20));
+          if (distance > t_tau) {
+            m_fps[k] += (uint128_t{distance} << 107);
           }
         }
       }
     }
-
-    return {sss, fps};
   }
 
-  template <typename t_char_type>
-  std::vector<std::pair<t_index, t_index>> calculate_q(t_char_type* const text,
-                                                       size_t size,
-                                                       const size_t from,
-                                                       const size_t to) {
+  // Return the intervals of positions in q. The run information of the
+  // positions that precede a run is appended to run_info. Runs are extended to
+  // the right up to max_run_end, which is size - 1 unless only a window of the
+  // text is available. Any max_run_end >= to + 3 * tau - 1 gives the same q in
+  // [from, to + tau], only the run information of longer runs may differ.
+  template <typename t_text>
+  std::vector<std::pair<t_index, t_index>> calculate_q(
+      t_text const& text, size_t size, const size_t from, const size_t to,
+      std::vector<std::pair<t_index, int64_t>>& run_info,
+      size_t const max_run_end) const {
     std::vector<std::pair<t_index, t_index>> qset{};  // inclusive intervals
     constexpr size_t small_tau = t_tau / 4;
 
-    rk_prime rk(small_tau, 296819);
+    t_rolling_hash rk(small_tau, 296819);
     for (size_t i = 0; i < small_tau; ++i) {
       rk.roll_in(text[from + i]);
     }
 
-    ring_buffer<uint128_t> fingerprints(4 * t_tau);
+    ring_buffer<fp_type> fingerprints(4 * t_tau);
     fingerprints.resize(from);
     fingerprints.push_back(rk.get_fp());
 
+    // The leftmost minima of the two ranges [i, i + small_tau) and
+    // [first_min + 1, first_min + small_tau) are found with sliding windows. A
+    // range contains at least its first position.
+    sliding_window_min<fp_type> first_window(std::max<size_t>(small_tau, 1));
+    sliding_window_min<fp_type> next_window(std::max<size_t>(small_tau, 2) - 1);
+    auto const fingerprint = [&fingerprints](size_t const pos) {
+      return fingerprints[pos];
+    };
+
     for (size_t i = from; i < to + t_tau; ++i) {  //++i correct?
       for (size_t j = fingerprints.size(); j < i + t_tau; ++j) {
         fingerprints.push_back(rk.roll(text[j - 1], text[j + small_tau - 1]));
       }
       // find first minimum
-      size_t first_min = i;
-      for (size_t j = first_min; j < i + small_tau; ++j) {
-        if (fingerprints[j] < fingerprints[first_min]) {
-          first_min = j;
-        }
-      }
+      size_t const first_min = first_window.min_pos(i, fingerprint);
       // find next minimum
-      size_t next_min = first_min + 1;
-      for (size_t j = next_min; j < first_min + small_tau; ++j) {
-        if (fingerprints[j] < fingerprints[next_min]) {
-          next_min = j;
-        }
-      }
+      size_t const next_min = next_window.min_pos(first_min + 1, fingerprint);
 
       // if minimum fps match, look for run
       if (fingerprints[next_min] != fingerprints[first_min]) {
@@ -346,7 +361,7 @@ class sss {
         // extend run naivly to the right
         size_t run_end = next_min;  // inclusive
         // while (run_end < to + 2 * t_tau - 2 &&
-        while (run_end < (size - 1) &&
+        while (run_end < max_run_end &&
                text[run_end + 1] == text[run_end - period + 1]) {
           ++run_end;
         }
@@ -364,18 +379,18 @@ class sss {
               continue;  // Run starts at previous PE, we are not responsible
             }
 
-            while (run_end < size - 1 &&
+            while (run_end < max_run_end &&
                    text[run_end + 1] == text[run_end - period + 1]) {
               ++run_end;
             }
 
             size_t const sss_pos1 = run_start - 1;
             size_t const sss_pos2 = run_end - (2 * t_tau) + 2;
-            int64_t const run_info = int64_t{1} * size - sss_pos2 + sss_pos1;
-            m_run_info[sss_pos1] =
-                text[run_end + 1] > text[run_end - period + 1]
-                    ? run_info
-                    : run_info * (-1);
+            int64_t const info = int64_t{1} * size - sss_pos2 + sss_pos1;
+            run_info.emplace_back(
+                sss_pos1, text[run_end + 1] > text[run_end - period + 1]
+                              ? info
+                              : info * (-1));
           }
         } else {
           i = next_min - 1;
@@ -398,17 +413,35 @@ class sss {
     return m_sss;
   }
 
-  std::vector<uint128_t> const& get_fps() const {
+  std::vector<stored_fp_type> const& get_fps() const {
     assert(m_fps_calculated);
     return m_fps;
   }
   void free_fps() {
-    m_fps = std::vector<uint128_t>{};
+    m_fps = std::vector<stored_fp_type>{};
+    m_run_distances = std::vector<std::pair<t_index, t_index>>{};
     m_fps_calculated = false;
   }
 
+  // Return the distance from the i-th position in the sss to the next one if
+  // the i-th position precedes a run, and 0 otherwise.
+  uint64_t get_run_distance(size_t i) const {
+    assert(m_fps_calculated);
+    if constexpr (t_compact_fps) {
+      auto run_distance_entry = std::lower_bound(
+          m_run_distances.begin(), m_run_distances.end(), i,
+          [](auto const& entry, size_t i) { return entry.first < i; });
+      return (run_distance_entry == m_run_distances.end() ||
+              run_distance_entry->first != i)
+                 ? 0
+                 : run_distance_entry->second;
+    } else {
+      return static_cast<uint64_t>(m_fps[i] >> 107);
+    }
+  }
+
   size_t num_runs() const {
-    return m_run_info.size();
+    return m_runs.size();
   }
   size_t has_runs() const {
     return m_runs_detected;
@@ -422,21 +455,96 @@ class sss {
     return m_sss[i];
   }
 
+  // Return the run information of text position pos, which is 0 if pos does
+  // not precede a run.
   int64_t get_run_info(size_t pos) const {
-    auto run_info_entry = m_run_info.find(pos);
-    return run_info_entry == m_run_info.end() ? 0 : run_info_entry->second;
+    auto run_info_entry = std::lower_bound(
+        m_runs.begin(), m_runs.end(), pos,
+        [](auto const& entry, size_t pos) { return entry.first < pos; });
+    return (run_info_entry == m_runs.end() || run_info_entry->first != pos)
+               ? 0
+               : run_info_entry->second;
+  }
+
+  // Return the run information of the i-th position in the sss in constant
+  // time.
+  int64_t get_run_info_at(size_t i) const {
+    assert(i < m_sss.size());
+    return m_run_info.empty() ? 0 : m_run_info[i];
   }
 
  private:
+  static constexpr uint128_t m_compact_prime = (uint128_t{1} << 61) - 1;
+
+  // Store the run distances of all threads and replace the fingerprints of
+  // their positions by the ids of the pairs of fingerprint and run distance.
+  void set_run_distances(
+      std::vector<std::vector<std::pair<t_index, t_index>>>&
+          run_distance_part) {
+    for (auto& part : run_distance_part) {
+      m_run_distances.insert(m_run_distances.end(), part.begin(), part.end());
+      part = {};
+    }
+    std::vector<size_t> order(m_run_distances.size());
+    std::iota(order.begin(), order.end(), 0);
+    auto const key = [this](size_t const k) {
+      return std::make_pair(m_fps[m_run_distances[k].first],
+                            m_run_distances[k].second);
+    };
+    std::sort(order.begin(), order.end(),
+              [&key](size_t lhs, size_t rhs) { return key(lhs) < key(rhs); });
+    std::vector<stored_fp_type> ids(order.size());
+    stored_fp_type id = stored_fp_type{1} << 63;
+    for (size_t k = 0; k < order.size(); ++k) {
+      if (k != 0 && key(order[k - 1]) != key(order[k])) {
+        ++id;
+      }
+      ids[order[k]] = id;
+    }
+    for (size_t k = 0; k < ids.size(); ++k) {
+      m_fps[m_run_distances[k].first] = ids[k];
+    }
+  }
+
+  // Store the run information of all threads sorted by position, and aligned
+  // with m_sss for constant time access.
+  void set_run_info(
+      std::vector<std::vector<std::pair<t_index, int64_t>>>& run_info_part) {
+    for (auto& part : run_info_part) {
+      m_runs.insert(m_runs.end(), part.begin(), part.end());
+      part = {};
+    }
+    // A run may be found by two threads.
+    std::sort(m_runs.begin(), m_runs.end());
+    m_runs.erase(std::unique(m_runs.begin(), m_runs.end(),
+                             [](auto const& lhs, auto const& rhs) {
+                               return lhs.first == rhs.first;
+                             }),
+                 m_runs.end());
+
+    m_run_info.resize(m_sss.size());
+#pragma omp parallel for
+    for (size_t i = 0; i < m_run_info.size(); ++i) {
+      m_run_info[i] = 0;
+    }
+    for (auto const& [pos, info] : m_runs) {
+      auto it = std::lower_bound(m_sss.begin(), m_sss.end(), pos);
+      if (it != m_sss.end() && *it == pos) {
+        m_run_info[it - m_sss.begin()] = info;
+      }
+    }
+  }
+
   std::vector<t_index> m_sss;
-  std::vector<uint128_t> m_fps;
+  std::vector<stored_fp_type> m_fps;
+  // With t_compact_fps, pairs of sss-indexes and their run distances.
+  std::vector<std::pair<t_index, t_index>> m_run_distances;
   bool m_fps_calculated;
 
-  phmap::parallel_flat_hash_map<
-      t_index, int64_t, phmap::priv::hash_default_hash<t_index>,
-      phmap::priv::hash_default_eq<t_index>,
-      phmap::priv::Allocator<std::pair<const t_index, int64_t>>, 4, std::mutex>
-      m_run_info;
+  // Pairs of positions that precede a run and their run information.
+  std::vector<std::pair<t_index, int64_t>> m_runs;
+  // Run information of each position in m_sss, empty if there are no runs.
+  std::vector<int64_t> m_run_info;
   bool m_runs_detected;
 };
 }  // namespace alx::rolling_hash
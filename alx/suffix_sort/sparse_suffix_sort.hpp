@@ -0,0 +1,63 @@
+/*******************************************************************************
+ * alx/suffix_sort/sparse_suffix_sort.hpp
+ *
+ * Copyright (C) 2026 Alexander Herlez <alexander.herlez@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#include <assert.h>
+#include <omp.h>
+
+#include <ips4o.hpp>
+#include <span>
+#include <vector>
+
+namespace alx::suffix_sort {
+
+// Sort the suffixes text[positions[k]..] lexicographically in parallel with
+// num_threads threads. Any alx LCE data structure over the text can be used,
+// as long as it answers is_leq_suffix from several threads at once.
+template <typename lce_ds_type, typename t_index_type>
+void sparse_suffix_sort(lce_ds_type const& lce_ds,
+                        std::span<t_index_type> positions,
+                        int num_threads = omp_get_max_threads()) {
+  auto const comp = [&lce_ds](t_index_type i, t_index_type j) {
+    return i != j && lce_ds.is_leq_suffix(i, j);
+  };
+  if (num_threads > 1) {
+    ips4o::parallel::sort(positions.begin(), positions.end(), comp,
+                          num_threads);
+  } else {
+    ips4o::sort(positions.begin(), positions.end(), comp);
+  }
+}
+
+// Return the sparse suffix array of the given text positions.
+template <typename lce_ds_type, typename t_index_type>
+std::vector<t_index_type> sparse_suffix_array(
+    lce_ds_type const& lce_ds, std::vector<t_index_type> positions,
+    int num_threads = omp_get_max_threads()) {
+  sparse_suffix_sort(lce_ds, std::span<t_index_type>(positions), num_threads);
+  return positions;
+}
+
+// Return the sparse LCP array of a sparse suffix array ssa, i.e., lcp[0] = 0
+// and lcp[k] is the lce of text[ssa[k-1]..] and text[ssa[k]..].
+template <typename lce_ds_type, typename t_index_type>
+std::vector<t_index_type> sparse_lcp_array(
+    lce_ds_type const& lce_ds, std::vector<t_index_type> const& ssa,
+    int num_threads = omp_get_max_threads()) {
+  std::vector<t_index_type> lcp(ssa.size());
+  if (ssa.empty()) {
+    return lcp;
+  }
+  lcp[0] = 0;
+#pragma omp parallel for num_threads(num_threads)
+  for (size_t k = 1; k < ssa.size(); ++k) {
+    lcp[k] = lce_ds.lce(ssa[k - 1], ssa[k]);
+  }
+  return lcp;
+}
+}  // namespace alx::suffix_sort
@@ -0,0 +1,475 @@
+/*******************************************************************************
+ * alx/suffix_sort/suffix_array_construction.hpp
+ *
+ * Copyright (C) 2026 Alexander Herlez <alexander.herlez@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#include <assert.h>
+#include <libsais.h>
+#include <libsais64.h>
+#include <omp.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <gsaca-double-sort-par.hpp>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "lce/lce_naive_wordwise.hpp"
+#include "util/blocked_scatter.hpp"
+
+namespace alx::suffix_sort {
+
+// Construction of the suffix array (SA), the inverse suffix array (ISA), the
+// LCP array and the permuted LCP array (PLCP) with a selectable backend. A
+// backend is a policy with the static member functions
+//   suffix_array(text, size, sa),
+//   plcp_array(text, size, sa, plcp) and
+//   lcp_array(text, size, sa, isa, lcp),
+// and the flag phi_lcp, which tells whether lcp_array permutes the PLCP array
+// (see with_phi_lcp). Here lcp[0] = 0 and lcp[k] is the lce of text[sa[k-1]..]
+// and text[sa[k]..], and plcp[sa[k]] = lcp[k].
+
+// Store the LCP array in lcp with a parallel variant of the algorithm of Kasai
+// et al. Each thread scans a slice of the text in text order.
+template <typename t_char_type, typename t_index_type>
+void lcp_array_kasai(t_char_type const* text, size_t size,
+                     t_index_type const* sa, t_index_type const* isa,
+                     t_index_type* lcp) {
+  if (size == 0) {
+    return;
+  }
+  lcp[0] = 0;
+#pragma omp parallel
+  {
+    const int t = omp_get_thread_num();
+    const int nt = omp_get_num_threads();
+    const size_t slice_size = size / nt;
+
+    const size_t begin = t * slice_size;
+    const size_t end = (t < nt - 1) ? (t + 1) * slice_size : size;
+
+    size_t current_lcp = 0;
+    for (size_t i{begin}; i < end; ++i) {
+      size_t suffix_array_pos = isa[i];
+      if (suffix_array_pos == 0) {
+        continue;
+      }
+      size_t preceding_suffix_pos = sa[suffix_array_pos - 1];
+      current_lcp += alx::lce::lce_naive_wordwise<t_char_type>::lce_uneq(
+          text, size, i + current_lcp, preceding_suffix_pos + current_lcp);
+      lcp[suffix_array_pos] = current_lcp;
+      assert(alx::lce::lce_naive_wordwise<t_char_type>::lce_uneq(
+                 text, size, i, preceding_suffix_pos) == current_lcp);
+
+      if (current_lcp != 0) {
+        --current_lcp;
+      }
+    }
+  }
+}
+
+// Store the PLCP array in plcp with the help of the PHI array, i.e.,
+// phi[SA[k]] = SA[k-1]. The PHI array is overwritten by the PLCP array, so no
+// ISA is needed. Apart from building the PHI array, the text is scanned in
+// order, so the only random accesses are the reads of text[phi[i]..].
+template <typename t_char_type, typename t_index_type>
+void plcp_array_phi(t_char_type const* text, size_t size,
+                    t_index_type const* sa, t_index_type* plcp) {
+  alx::util::blocked_scatter(
+      size, plcp, size, [sa](size_t k) { return static_cast<size_t>(sa[k]); },
+      [sa, size](size_t k) {
+        return (k == 0) ? size : static_cast<size_t>(sa[k - 1]);
+      });
+#pragma omp parallel
+  {
+    const int t = omp_get_thread_num();
+    const int nt = omp_get_num_threads();
+    const size_t slice_size = size / nt;
+
+    const size_t begin = t * slice_size;
+    const size_t end = (t < nt - 1) ? (t + 1) * slice_size : size;
+
+    size_t current_lcp = 0;
+    for (size_t i{begin}; i < end; ++i) {
+      size_t const preceding_suffix_pos = plcp[i];
+      if (preceding_suffix_pos == size) {
+        plcp[i] = 0;
+        current_lcp = 0;
+        continue;
+      }
+      current_lcp += alx::lce::lce_naive_wordwise<t_char_type>::lce_uneq(
+          text, size, i + current_lcp, preceding_suffix_pos + current_lcp);
+      plcp[i] = current_lcp;
+      if (current_lcp != 0) {
+        --current_lcp;
+      }
+    }
+  }
+}
+
+// Suffix sorting with gsaca-double-sort. The LCP array is computed with
+// Kasai's algorithm and the PLCP array with the PHI array.
+struct gsaca_backend {
+  static constexpr char const* name = "gsaca";
+  static constexpr bool phi_lcp = false;
+
+  template <typename t_char_type, typename t_index_type>
+  static void suffix_array(t_char_type const* text, size_t size,
+                           t_index_type* sa) {
+    gsaca_for_lce(text, sa, size);
+  }
+
+  template <typename t_char_type, typename t_index_type>
+  static void plcp_array(t_char_type const* text, size_t size,
+                         t_index_type const* sa, t_index_type* plcp) {
+    plcp_array_phi(text, size, sa, plcp);
+  }
+
+  template <typename t_char_type, typename t_index_type>
+  static void lcp_array(t_char_type const* text, size_t size,
+                        t_index_type const* sa, t_index_type const* isa,
+                        t_index_type* lcp) {
+    lcp_array_kasai(text, size, sa, isa, lcp);
+  }
+};
+
+// Suffix sorting with libsais (texts of less than 2^31 characters) or
+// libsais64. Byte texts are sorted directly. Larger alphabets, e.g., the
+// reduced fingerprints of lce_sss, are remapped to [0, sigma) and sorted with
+// the integer alphabet variants libsais_int and libsais64_long. If libsais is
+// built with LIBSAIS_OPENMP, the parallel variants are used.
+//
+// libsais writes 32 or 64 bit signed integers. If t_index_type has a different
+// layout, e.g., uint40_t, the suffix array is copied from a temporary array.
+// The PLCP and LCP arrays are computed by libsais only for byte texts whose
+// suffix array can be passed without a copy, and otherwise as with
+// gsaca_backend. If libsais returns an error, e.g., because it cannot allocate
+// its working space, the array is computed as with gsaca_backend as well.
+struct libsais_backend {
+  static constexpr char const* name = "libsais";
+  static constexpr bool phi_lcp = false;
+
+  template <typename t_char_type, typename t_index_type>
+  static void suffix_array(t_char_type const* text, size_t size,
+                           t_index_type* sa) {
+    if (size == 0) {
+      return;
+    }
+    if constexpr (is_byte_type<t_char_type>()) {
+      auto const* bytes = reinterpret_cast<uint8_t const*>(text);
+      bool sorted = false;
+      if (use_libsais32<t_index_type>(size)) {
+        sorted = sais_into<int32_t>(sa, size, [&](int32_t* out) {
+          return sais(bytes, out, static_cast<int32_t>(size));
+        });
+      } else {
+        sorted = sais_into<int64_t>(sa, size, [&](int64_t* out) {
+          return sais(bytes, out, static_cast<int64_t>(size));
+        });
+      }
+      if (!sorted) {
+        gsaca_backend::suffix_array(text, size, sa);
+      }
+    } else if constexpr (sizeof(t_char_type) <= sizeof(uint64_t)) {
+      suffix_array_int(text, size, sa);
+    } else {
+      gsaca_backend::suffix_array(text, size, sa);
+    }
+  }
+
+  template <typename t_char_type, typename t_index_type>
+  static void plcp_array(t_char_type const* text, size_t size,
+                         t_index_type const* sa, t_index_type* plcp) {
+    if constexpr (is_byte_type<t_char_type>() &&
+                  is_sais_layout<t_index_type, int32_t>()) {
+      if (size != 0 && size <= max_sais32_size &&
+          sais_plcp(reinterpret_cast<uint8_t const*>(text),
+                    reinterpret_cast<int32_t const*>(sa),
+                    reinterpret_cast<int32_t*>(plcp),
+                    static_cast<int32_t>(size)) == 0) {
+        return;
+      }
+    } else if constexpr (is_byte_type<t_char_type>() &&
+                         is_sais_layout<t_index_type, int64_t>()) {
+      if (size != 0 &&
+          sais_plcp(reinterpret_cast<uint8_t const*>(text),
+                    reinterpret_cast<int64_t const*>(sa),
+                    reinterpret_cast<int64_t*>(plcp),
+                    static_cast<int64_t>(size)) == 0) {
+        return;
+      }
+    }
+    plcp_array_phi(text, size, sa, plcp);
+  }
+
+  template <typename t_char_type, typename t_index_type>
+  static void lcp_array(t_char_type const* text, size_t size,
+                        t_index_type const* sa, t_index_type const* isa,
+                        t_index_type* lcp) {
+    if constexpr (is_byte_type<t_char_type>() &&
+                  (is_sais_layout<t_index_type, int32_t>() ||
+                   is_sais_layout<t_index_type, int64_t>())) {
+      using sais_index_type =
+          std::conditional_t<sizeof(t_index_type) == sizeof(int32_t), int32_t,
+                             int64_t>;
+      if (size != 0 && size <= std::numeric_limits<sais_index_type>::max()) {
+        std::vector<sais_index_type> plcp(size);
+        auto const* sais_sa = reinterpret_cast<sais_index_type const*>(sa);
+        if (sais_plcp(reinterpret_cast<uint8_t const*>(text), sais_sa,
+                      plcp.data(), static_cast<sais_index_type>(size)) == 0 &&
+            sais_lcp(plcp.data(), sais_sa,
+                     reinterpret_cast<sais_index_type*>(lcp),
+                     static_cast<sais_index_type>(size)) == 0) {
+          lcp[0] = 0;
+          return;
+        }
+      }
+    }
+    lcp_array_kasai(text, size, sa, isa, lcp);
+  }
+
+ private:
+  static constexpr size_t max_sais32_size =
+      std::numeric_limits<int32_t>::max();
+
+  template <typename t_char_type>
+  static constexpr bool is_byte_type() {
+    return sizeof(t_char_type) == 1 && std::is_unsigned_v<t_char_type>;
+  }
+
+  // Return whether an array of t_index_type can be passed to libsais as an
+  // array of t_sais_index_type.
+  template <typename t_index_type, typename t_sais_index_type>
+  static constexpr bool is_sais_layout() {
+    return std::is_integral_v<t_index_type> &&
+           sizeof(t_index_type) == sizeof(t_sais_index_type);
+  }
+
+  // Return whether the 32 bit variant of libsais sorts a text of the given
+  // size into an array of t_index_type with at most 4 bytes of extra space.
+  template <typename t_index_type>
+  static bool use_libsais32(size_t size) {
+    return size <= max_sais32_size && sizeof(t_index_type) < sizeof(int64_t);
+  }
+
+  // Run sort_fn on an array of t_sais_index_type and store the result in sa.
+  // If sa has the same layout, libsais writes into it directly. Return false
+  // if libsais returned an error.
+  template <typename t_sais_index_type, typename t_index_type,
+            typename t_sort_fn>
+  static bool sais_into(t_index_type* sa, size_t size, t_sort_fn sort_fn) {
+    if constexpr (is_sais_layout<t_index_type, t_sais_index_type>()) {
+      return sort_fn(reinterpret_cast<t_sais_index_type*>(sa)) == 0;
+    } else {
+      std::vector<t_sais_index_type> buffer(size);
+      if (sort_fn(buffer.data()) != 0) {
+        return false;
+      }
+#pragma omp parallel for
+      for (size_t k = 0; k < size; ++k) {
+        sa[k] = static_cast<uint64_t>(buffer[k]);
+      }
+      return true;
+    }
+  }
+
+  // Sort a text over an integer alphabet. The characters are shifted to
+  // [0, sigma), so that the alphabet size passed to libsais is minimal.
+  template <typename t_char_type, typename t_index_type>
+  static void suffix_array_int(t_char_type const* text, size_t size,
+                               t_index_type* sa) {
+    using value_type = std::conditional_t<std::is_signed_v<t_char_type>,
+                                          int64_t, uint64_t>;
+    value_type min_char = static_cast<value_type>(text[0]);
+    value_type max_char = min_char;
+#pragma omp parallel for reduction(min : min_char) reduction(max : max_char)
+    for (size_t i = 0; i < size; ++i) {
+      value_type const c = static_cast<value_type>(text[i]);
+      min_char = std::min(min_char, c);
+      max_char = std::max(max_char, c);
+    }
+    uint64_t const sigma = static_cast<uint64_t>(max_char - min_char) + 1;
+
+    auto remap = [&]<typename t_int_type>(std::vector<t_int_type>& int_text) {
+#pragma omp parallel for
+      for (size_t i = 0; i < size; ++i) {
+        int_text[i] = static_cast<t_int_type>(
+            static_cast<value_type>(text[i]) - min_char);
+      }
+    };
+
+    bool sorted = false;
+    if (use_libsais32<t_index_type>(size) && sigma <= max_sais32_size) {
+      std::vector<int32_t> int_text(size);
+      remap(int_text);
+      sorted = sais_into<int32_t>(sa, size, [&](int32_t* out) {
+        return sais_int(int_text.data(), out, static_cast<int32_t>(size),
+                        static_cast<int32_t>(sigma));
+      });
+    } else if (sigma != 0 &&
+               sigma <= static_cast<uint64_t>(
+                            std::numeric_limits<int64_t>::max())) {
+      std::vector<int64_t> int_text(size);
+      remap(int_text);
+      sorted = sais_into<int64_t>(sa, size, [&](int64_t* out) {
+        return sais_int(int_text.data(), out, static_cast<int64_t>(size),
+                        static_cast<int64_t>(sigma));
+      });
+    }
+    if (!sorted) {
+      gsaca_backend::suffix_array(text, size, sa);
+    }
+  }
+
+  // Overloads that call the parallel variants of libsais if available.
+  static int32_t sais(uint8_t const* text, int32_t* sa, int32_t size) {
+#ifdef LIBSAIS_OPENMP
+    return libsais_omp(text, sa, size, 0, nullptr, 0);
+#else
+    return libsais(text, sa, size, 0, nullptr);
+#endif
+  }
+
+  static int64_t sais(uint8_t const* text, int64_t* sa, int64_t size) {
+#ifdef LIBSAIS_OPENMP
+    return libsais64_omp(text, sa, size, 0, nullptr, 0);
+#else
+    return libsais64(text, sa, size, 0, nullptr);
+#endif
+  }
+
+  static int32_t sais_int(int32_t* text, int32_t* sa, int32_t size,
+                          int32_t sigma) {
+#ifdef LIBSAIS_OPENMP
+    return libsais_int_omp(text, sa, size, sigma, 0, 0);
+#else
+    return libsais_int(text, sa, size, sigma, 0);
+#endif
+  }
+
+  static int64_t sais_int(int64_t* text, int64_t* sa, int64_t size,
+                          int64_t sigma) {
+#ifdef LIBSAIS_OPENMP
+    return libsais64_long_omp(text, sa, size, sigma, 0, 0);
+#else
+    return libsais64_long(text, sa, size, sigma, 0);
+#endif
+  }
+
+  static int32_t sais_plcp(uint8_t const* text, int32_t const* sa,
+                           int32_t* plcp, int32_t size) {
+#ifdef LIBSAIS_OPENMP
+    return libsais_plcp_omp(text, sa, plcp, size, 0);
+#else
+    return libsais_plcp(text, sa, plcp, size);
+#endif
+  }
+
+  static int64_t sais_plcp(uint8_t const* text, int64_t const* sa,
+                           int64_t* plcp, int64_t size) {
+#ifdef LIBSAIS_OPENMP
+    return libsais64_plcp_omp(text, sa, plcp, size, 0);
+#else
+    return libsais64_plcp(text, sa, plcp, size);
+#endif
+  }
+
+  static int32_t sais_lcp(int32_t const* plcp, int32_t const* sa, int32_t* lcp,
+                          int32_t size) {
+#ifdef LIBSAIS_OPENMP
+    return libsais_lcp_omp(plcp, sa, lcp, size, 0);
+#else
+    return libsais_lcp(plcp, sa, lcp, size);
+#endif
+  }
+
+  static int64_t sais_lcp(int64_t const* plcp, int64_t const* sa, int64_t* lcp,
+                          int64_t size) {
+#ifdef LIBSAIS_OPENMP
+    return libsais64_lcp_omp(plcp, sa, lcp, size, 0);
+#else
+    return libsais64_lcp(plcp, sa, lcp, size);
+#endif
+  }
+};
+
+// Store the LCP array in lcp by permuting the PLCP array of t_backend, i.e.,
+// lcp[isa[i]] = plcp[i]. The PLCP array is built with sequential text access
+// and then permuted with one blocked scatter, whereas Kasai's algorithm reads
+// isa[i] and sa[isa[i] - 1] and writes lcp[isa[i]] at random in each step.
+// This needs space for the PLCP array in addition.
+template <typename t_backend, typename t_char_type, typename t_index_type>
+void lcp_array_from_plcp(t_char_type const* text, size_t size,
+                         t_index_type const* sa, t_index_type const* isa,
+                         t_index_type* lcp) {
+  std::vector<t_index_type> plcp(size);
+  t_backend::plcp_array(text, size, sa, plcp.data());
+  alx::util::blocked_scatter(
+      size, lcp, size, [isa](size_t i) { return static_cast<size_t>(isa[i]); },
+      [&plcp](size_t i) { return plcp[i]; });
+}
+
+// The backend t_backend, but the LCP array is computed from the PLCP array
+// with lcp_array_from_plcp.
+template <typename t_backend>
+struct with_phi_lcp : t_backend {
+  static constexpr bool phi_lcp = true;
+
+  template <typename t_char_type, typename t_index_type>
+  static void lcp_array(t_char_type const* text, size_t size,
+                        t_index_type const* sa, t_index_type const* isa,
+                        t_index_type* lcp) {
+    lcp_array_from_plcp<t_backend>(text, size, sa, isa, lcp);
+  }
+};
+
+// Return the suffix array of text[0..size).
+template <typename t_index_type, typename t_backend = gsaca_backend,
+          typename t_char_type>
+std::vector<t_index_type> suffix_array(t_char_type const* text, size_t size) {
+  std::vector<t_index_type> sa(size);
+  t_backend::suffix_array(text, size, sa.data());
+  return sa;
+}
+
+// Return the inverse suffix array, i.e., isa[sa[k]] = k. The scatter is
+// blocked, see util/blocked_scatter.hpp.
+template <typename t_index_type>
+std::vector<t_index_type> inverse_suffix_array(
+    std::vector<t_index_type> const& sa) {
+  std::vector<t_index_type> isa(sa.size());
+  alx::util::blocked_scatter(
+      sa.size(), isa.data(), isa.size(),
+      [&sa](size_t k) { return static_cast<size_t>(sa[k]); },
+      [](size_t k) { return k; });
+  return isa;
+}
+
+// Return the PLCP array of text[0..size), i.e., plcp[sa[k]] = lcp[k].
+template <typename t_backend = gsaca_backend, typename t_char_type,
+          typename t_index_type>
+std::vector<t_index_type> plcp_array(t_char_type const* text, size_t size,
+                                     std::vector<t_index_type> const& sa) {
+  assert(sa.size() == size);
+  std::vector<t_index_type> plcp(size);
+  t_backend::plcp_array(text, size, sa.data(), plcp.data());
+  return plcp;
+}
+
+// Return the LCP array of text[0..size).
+template <typename t_backend = gsaca_backend, typename t_char_type,
+          typename t_index_type>
+std::vector<t_index_type> lcp_array(t_char_type const* text, size_t size,
+                                    std::vector<t_index_type> const& sa,
+                                    std::vector<t_index_type> const& isa) {
+  assert(sa.size() == size && isa.size() == size);
+  std::vector<t_index_type> lcp(size);
+  t_backend::lcp_array(text, size, sa.data(), isa.data(), lcp.data());
+  return lcp;
+}
+}  // namespace alx::suffix_sort
@@ -0,0 +1,180 @@
+/*******************************************************************************
+ * alx/util/blocked_scatter.hpp
+ *
+ * Copyright (C) 2026 Alexander Herlez <alexander.herlez@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#include <assert.h>
+#include <immintrin.h>
+#include <omp.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace alx::util {
+
+// Set out[target(k)] = value(k) for each k in [0, size) in parallel. The
+// targets must be smaller than out_size and pairwise different.
+//
+// A plain scatter misses the cache with each write once out does not fit into
+// the cache. Here the pairs (target(k), value(k)) are first radix partitioned
+// by the block of out they are written to, so that each block is written by
+// one thread while it resides in its L2 cache. Blocks have t_block_bytes bytes,
+// but there are at most 2^t_max_fanout_bits of them.
+//
+// The partitioning collects the pairs of each block in a cache line sized
+// buffer and flushes full lines with non-temporal stores, so the partition
+// buffer is never read before it is written. To bound the extra space, the
+// positions are processed in t_num_rounds rounds, each needing a buffer of
+// size / t_num_rounds pairs.
+template <size_t t_block_bytes = (size_t{1} << 18), size_t t_num_rounds = 4,
+          size_t t_max_fanout_bits = 11, typename t_out_type,
+          typename t_target_fn, typename t_value_fn>
+void blocked_scatter(size_t size, t_out_type* out, size_t out_size,
+                     t_target_fn target, t_value_fn value) {
+  static_assert(t_num_rounds >= 1);
+  constexpr size_t min_block_bits =
+      std::bit_width(std::max<size_t>(t_block_bytes / sizeof(t_out_type), 2)) -
+      1;
+  size_t const out_bits = std::bit_width(out_size);
+  size_t const block_bits = std::max<size_t>(
+      min_block_bits, out_bits - std::min(out_bits, t_max_fanout_bits));
+  size_t const num_blocks = (out_size >> block_bits) + 1;
+
+  // Small outputs fit into the cache anyway.
+  if (num_blocks <= 2 || size < (size_t{1} << 16)) {
+#pragma omp parallel for
+    for (size_t k = 0; k < size; ++k) {
+      out[target(k)] = value(k);
+    }
+    return;
+  }
+
+  struct target_value {
+    t_out_type target;
+    t_out_type value;
+  };
+  constexpr size_t line_bytes = 64;
+  constexpr bool use_lines = (line_bytes % sizeof(target_value) == 0);
+  constexpr size_t line_size =
+      use_lines ? line_bytes / sizeof(target_value) : 1;
+
+  // Return the first entry of memory at a cache line boundary.
+  auto const align = []<typename T>(T* memory) {
+    size_t const offset = reinterpret_cast<uintptr_t>(memory) % line_bytes;
+    return memory + (offset == 0 ? 0 : (line_bytes - offset) / sizeof(T));
+  };
+
+  size_t const round_size = (size + t_num_rounds - 1) / t_num_rounds;
+  // The buffer is not initialized, the partitioning writes each entry first.
+  std::unique_ptr<target_value[]> buffer_memory(
+      new target_value[round_size + line_size]);
+  target_value* const buffer =
+      use_lines ? align(buffer_memory.get()) : buffer_memory.get();
+
+  int const max_threads = omp_get_max_threads();
+  // Per thread and block, the number of pairs and then the write position.
+  std::vector<size_t> positions(max_threads * num_blocks);
+  // Per thread and block, the first write position.
+  std::vector<size_t> piece_begin(max_threads * num_blocks);
+  // The begin of each block in the buffer.
+  std::vector<size_t> block_begin(num_blocks + 1);
+
+  for (size_t round_begin = 0; round_begin < size; round_begin += round_size) {
+    size_t const round_end = std::min(round_begin + round_size, size);
+#pragma omp parallel num_threads(max_threads)
+    {
+      const int t = omp_get_thread_num();
+      const int nt = omp_get_num_threads();
+      const size_t slice_size = (round_end - round_begin) / nt;
+      const size_t begin = round_begin + t * slice_size;
+      const size_t end =
+          (t < nt - 1) ? round_begin + (t + 1) * slice_size : round_end;
+      size_t* const pos = positions.data() + t * num_blocks;
+      size_t const* const pos_begin = piece_begin.data() + t * num_blocks;
+
+      std::fill_n(pos, num_blocks, 0);
+      for (size_t k = begin; k < end; ++k) {
+        ++pos[static_cast<size_t>(target(k)) >> block_bits];
+      }
+#pragma omp barrier
+#pragma omp single
+      {
+        // Pairs are grouped by block, and inside a block by thread.
+        size_t sum = 0;
+        for (size_t b = 0; b < num_blocks; ++b) {
+          block_begin[b] = sum;
+          for (int s = 0; s < nt; ++s) {
+            size_t const count = positions[s * num_blocks + b];
+            positions[s * num_blocks + b] = sum;
+            piece_begin[s * num_blocks + b] = sum;
+            sum += count;
+          }
+        }
+        block_begin[num_blocks] = sum;
+        assert(sum == round_end - round_begin);
+      }
+
+      if constexpr (use_lines) {
+        // lines[b] caches the buffer line that block b writes.
+        struct alignas(line_bytes) cache_line {
+          target_value entries[line_size];
+        };
+        std::unique_ptr<cache_line[]> lines(new cache_line[num_blocks]);
+        for (size_t k = begin; k < end; ++k) {
+          size_t const tgt = target(k);
+          size_t const b = tgt >> block_bits;
+          size_t const p = pos[b]++;
+          target_value* const line = lines[b].entries;
+          line[p % line_size] = {static_cast<t_out_type>(tgt),
+                                 static_cast<t_out_type>(value(k))};
+          if (p % line_size == line_size - 1) {
+            size_t const line_begin = p + 1 - line_size;
+            if (line_begin >= pos_begin[b]) {
+              auto* const src = reinterpret_cast<__m128i const*>(line);
+              auto* const dst = reinterpret_cast<__m128i*>(buffer + line_begin);
+              _mm_stream_si128(dst, _mm_load_si128(src));
+              _mm_stream_si128(dst + 1, _mm_load_si128(src + 1));
+              _mm_stream_si128(dst + 2, _mm_load_si128(src + 2));
+              _mm_stream_si128(dst + 3, _mm_load_si128(src + 3));
+            } else {
+              // The line is shared with the piece of another thread.
+              std::copy(line + pos_begin[b] % line_size, line + line_size,
+                        buffer + pos_begin[b]);
+            }
+          }
+        }
+        // Write the partial lines at the ends of the pieces.
+        for (size_t b = 0; b < num_blocks; ++b) {
+          size_t const line_begin =
+              std::max(pos_begin[b], pos[b] - pos[b] % line_size);
+          target_value const* const line = lines[b].entries;
+          std::copy(line + line_begin % line_size,
+                    line + line_begin % line_size + (pos[b] - line_begin),
+                    buffer + line_begin);
+        }
+        _mm_sfence();
+      } else {
+        for (size_t k = begin; k < end; ++k) {
+          size_t const tgt = target(k);
+          buffer[pos[tgt >> block_bits]++] = {
+              static_cast<t_out_type>(tgt), static_cast<t_out_type>(value(k))};
+        }
+      }
+#pragma omp barrier
+#pragma omp for schedule(dynamic, 16)
+      for (size_t b = 0; b < num_blocks; ++b) {
+        for (size_t p = block_begin[b]; p < block_begin[b + 1]; ++p) {
+          out[static_cast<size_t>(buffer[p].target)] = buffer[p].value;
+        }
+      }
+    }
+  }
+}
+}  // namespace alx::util
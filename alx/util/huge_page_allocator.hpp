@@ -0,0 +1,81 @@
+/*******************************************************************************
+ * alx/util/huge_page_allocator.hpp
+ *
+ * Copyright (C) 2026 Alexander Herlez <alexander.herlez@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#include <sys/mman.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+namespace alx::util {
+
+// Allocator for large tables that are accessed randomly. Allocations of at
+// least one huge page are aligned to huge pages and marked for transparent huge
+// pages, so that random accesses cause fewer TLB misses. Smaller allocations
+// are aligned to cache lines.
+//
+// Elements are default initialized, i.e., std::vector::resize does not fill
+// trivial types with zeros.
+template <typename T>
+class huge_page_allocator {
+ public:
+  using value_type = T;
+  static constexpr size_t huge_page_size = size_t{1} << 21;
+  static constexpr size_t cache_line_size = 64;
+
+  huge_page_allocator() = default;
+  template <typename U>
+  huge_page_allocator(huge_page_allocator<U> const&) noexcept {
+  }
+
+  T* allocate(size_t n) {
+    size_t const bytes = n * sizeof(T);
+    size_t const alignment =
+        bytes >= huge_page_size ? huge_page_size : cache_line_size;
+    size_t const rounded = (bytes + alignment - 1) / alignment * alignment;
+    // Use malloc, so that the memory is seen by malloc_count. The pointer
+    // returned by malloc is stored in front of the aligned memory.
+    char* const memory =
+        static_cast<char*>(std::malloc(rounded + alignment + sizeof(void*)));
+    if (memory == nullptr) {
+      throw std::bad_alloc();
+    }
+    uintptr_t const begin = reinterpret_cast<uintptr_t>(memory) +
+                            sizeof(void*) + alignment - 1;
+    char* const aligned = memory + (begin / alignment * alignment -
+                                    reinterpret_cast<uintptr_t>(memory));
+    reinterpret_cast<void**>(aligned)[-1] = memory;
+#ifdef MADV_HUGEPAGE
+    if (alignment == huge_page_size) {
+      madvise(aligned, rounded, MADV_HUGEPAGE);
+    }
+#endif
+    return reinterpret_cast<T*>(aligned);
+  }
+
+  void deallocate(T* memory, size_t) noexcept {
+    std::free(reinterpret_cast<void**>(memory)[-1]);
+  }
+
+  template <typename U, typename... Args>
+  void construct(U* p, Args&&... args) {
+    if constexpr (sizeof...(Args) == 0) {
+      ::new (static_cast<void*>(p)) U;
+    } else {
+      ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+  }
+
+  template <typename U>
+  bool operator==(huge_page_allocator<U> const&) const noexcept {
+    return true;
+  }
+};  // class huge_page_allocator
+}  // namespace alx::util
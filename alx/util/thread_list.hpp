@@ -0,0 +1,40 @@
+/*******************************************************************************
+ * alx/util/thread_list.hpp
+ *
+ * Copyright (C) 2026 Alexander Herlez <alexander.herlez@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace alx::util {
+
+// Parse a comma separated list of thread counts (e.g. "1,2,4,8") into
+// thread_counts. Return false if an entry is not a positive number.
+inline bool parse_thread_list(std::string const& threads_list,
+                              std::vector<size_t>& thread_counts) {
+  thread_counts.clear();
+  size_t pos = 0;
+  while (pos < threads_list.size()) {
+    size_t const next =
+        std::min(threads_list.find(',', pos), threads_list.size());
+    size_t num_threads = 0;
+    try {
+      num_threads = std::stoul(threads_list.substr(pos, next - pos));
+    } catch (std::exception const&) {
+    }
+    if (num_threads == 0) {
+      return false;
+    }
+    thread_counts.push_back(num_threads);
+    pos = next + 1;
+  }
+  return true;
+}
+}  // namespace alx::util
@@ -19,16 +19,22 @@
 #include <filesystem>
 #include <gsaca-double-sort/uint_types.hpp>  // uint40_t
 #include <iostream>
+#include <span>
 #include <string>
 #include <tlx/cmdline_parser.hpp>
+#include <utility>
 #include <vector>
 
 #ifdef ALX_BUILD_LCE_SDSL
 #include "lce/lce_sdsl_cst.hpp"
 #endif
 #include "lce/lce_classic.hpp"
+#include "lce/lce_classic_compressed.hpp"
 #include "lce/lce_fp.hpp"
+#include "lce/lce_fp_mersenne.hpp"
+#include "lce/lce_fp_sampled.hpp"
 #include "lce/lce_naive.hpp"
+#include "lce/lce_naive_simd.hpp"
 #include "lce/lce_naive_std.hpp"
 #include "lce/lce_naive_wordwise.hpp"
 #include "lce/lce_naive_wordwise_xor.hpp"
@@ -36,7 +42,9 @@
 #include "lce/lce_sss.hpp"
 #include "lce/lce_sss_naive.hpp"
 #include "lce/lce_sss_noss.hpp"
+#include "rmq/rmq_succinct.hpp"
 #include "util/io.hpp"
+#include "util/thread_list.hpp"
 #include "util/timer.hpp"
 
 namespace fs = std::filesystem;
@@ -45,11 +53,24 @@ std::vector<std::string> algorithms{"naive",
                                     "naive_std",
                                     "naive_wordwise",
                                     "naive_wordwise_xor",
+                                    "naive_simd",
                                     "fp64",
                                     "fp128",
                                     "fp256",
                                     "fp512",
                                     "fp_unlimited",
+                                    "fp64_sep",
+                                    "fp256_sep",
+                                    "fp_mersenne64",
+                                    "fp_mersenne128",
+                                    "fp_mersenne256",
+                                    "fp_mersenne512",
+                                    "fp_sampled64",
+                                    "fp_sampled128",
+                                    "fp_sampled256",
+                                    "fp_sampled512",
+                                    "fp_sampled256_k4",
+                                    "fp_sampled256_k64",
                                     "rk-prezza",
                                     "sss_naive256",
                                     "sss_naive512",
@@ -59,6 +80,8 @@ std::vector<std::string> algorithms{"naive",
                                     "sss_naive512pl",
                                     "sss_naive1024pl",
                                     "sss_naive2048pl",
+                                    "sss_naive512c",
+                                    "sss_naive1024c",
                                     "sss_noss256",
                                     "sss_noss512",
                                     "sss_noss1024",
@@ -67,6 +90,8 @@ std::vector<std::string> algorithms{"naive",
                                     "sss_noss512pl",
                                     "sss_noss1024pl",
                                     "sss_noss2048pl",
+                                    "sss_noss512c",
+                                    "sss_noss1024c",
                                     "sss256",
                                     "sss512",
                                     "sss1024",
@@ -76,17 +101,34 @@ std::vector<std::string> algorithms{"naive",
                                     "sss1024pl",
                                     "sss2048pl",
                                     "classic",
+                                    "classic_compressed",
+                                    "classic_compressed4",
+                                    "classic_compressed_isa",
+                                    "classic_libsais",
+                                    "classic_compressed_libsais",
+                                    "sss512_libsais",
+                                    "sss512pl_libsais",
+                                    "classic_phi",
+                                    "classic_libsais_phi",
+                                    "sss512_phi",
+                                    "classic_succinct",
                                     "sdsl_cst"};
 std::vector<std::string> algorithm_sets{"all", "seq", "par", "main"};
 
 std::vector<std::string> algorithms_seq{"naive", "naive_std", "naive_wordwise",
-                                        "naive_wordwise_xor"};
+                                        "naive_wordwise_xor", "naive_simd"};
 std::vector<std::string> algorithms_par{
     "fp64",           "fp128",          "fp256",           "fp512",
+    "fp_mersenne64",  "fp_mersenne128", "fp_mersenne256",  "fp_mersenne512",
+    "fp64_sep",       "fp256_sep",
+    "fp_sampled64",   "fp_sampled128",  "fp_sampled256",   "fp_sampled512",
+    "fp_sampled256_k4", "fp_sampled256_k64",
     "sss_naive256",   "sss_naive512",   "sss_naive1024",   "sss_naive2048",
     "sss_naive256pl", "sss_naive512pl", "sss_naive1024pl", "sss_naive2048pl",
+    "sss_naive512c",  "sss_naive1024c",
     "sss_noss256",    "sss_noss512",    "sss_noss1024",    "sss_noss2048",
     "sss_noss256pl",  "sss_noss512pl",  "sss_noss1024pl",  "sss_noss2048pl",
+    "sss_noss512c",   "sss_noss1024c",
     "sss256",         "sss512",         "sss1024",         "sss2048",
     "sss256pl",       "sss512pl",       "sss1024pl",       "sss2048pl",
 };
@@ -107,6 +149,10 @@ class benchmark {
   size_t lce_to = 20;
 
   std::string algorithm = "naive";
+  bool batch = false;
+  bool offline = false;
+  std::string threads_list;
+  std::vector<size_t> thread_counts;
 
   bool check_parameters() {
     // Check text path
@@ -134,6 +180,12 @@ class benchmark {
       }
     }
 
+    // Check thread counts
+    if (!alx::util::parse_thread_list(threads_list, thread_counts)) {
+      fmt::print("Invalid thread list {}.\n", threads_list);
+      return false;
+    }
+
     // Check algorithm
     if (std::find(algorithms.begin(), algorithms.end(), algorithm) ==
             algorithms.end() &&
@@ -229,6 +281,16 @@ class benchmark {
     if (queries.empty()) {
       return;
     }
+    if constexpr (requires(std::span<const std::pair<size_t, size_t>> q,
+                           std::span<size_t> out) {
+                    lce_ds.lce_batch(q, out);
+                  }) {
+      if (batch) {
+        benchmark_batch_queries<lce_ds_type>(lce_ds);
+        return;
+      }
+    }
+    fmt::print(" q_mode=scalar");
     size_t check_sum = 0;
     alx::util::timer t;
     for (size_t i = 0; i < queries.size(); i += 2) {
@@ -239,6 +301,143 @@ class benchmark {
     fmt::print(" check_sum={}", check_sum);
   }
 
+  template <typename lce_ds_type>
+  void benchmark_batch_queries(lce_ds_type& lce_ds) {
+    std::vector<std::pair<size_t, size_t>> query_pairs(queries.size() / 2);
+    for (size_t i = 0; i < query_pairs.size(); ++i) {
+      query_pairs[i] = {queries[2 * i], queries[2 * i + 1]};
+    }
+    std::vector<size_t> results(query_pairs.size());
+
+    fmt::print(" q_mode=batch");
+    alx::util::timer t;
+    lce_ds.lce_batch(query_pairs, results);
+    fmt::print(" q_time={}", t.get());
+
+    size_t check_sum = 0;
+    for (size_t const result : results) {
+      check_sum += result;
+    }
+    fmt::print(" check_sum={}", check_sum);
+  }
+
+  // Answer the loaded queries once for each number of threads in
+  // thread_counts. Each thread answers a contiguous slice of the queries
+  // against the same shared data structure.
+  template <typename lce_ds_type>
+  void benchmark_parallel_queries(lce_ds_type& lce_ds,
+                                  std::string const& algo_name,
+                                  size_t lce_cur) {
+    if (queries.empty()) {
+      return;
+    }
+    bool use_batch = false;
+    std::vector<std::pair<size_t, size_t>> query_pairs;
+    std::vector<size_t> results;
+    if constexpr (requires(std::span<const std::pair<size_t, size_t>> q,
+                           std::span<size_t> out) {
+                    lce_ds.lce_batch(q, out);
+                  }) {
+      if (batch) {
+        use_batch = true;
+        query_pairs.resize(queries.size() / 2);
+        for (size_t i = 0; i < query_pairs.size(); ++i) {
+          query_pairs[i] = {queries[2 * i], queries[2 * i + 1]};
+        }
+        results.resize(query_pairs.size());
+      }
+    }
+
+    size_t const num_pairs = queries.size() / 2;
+    double base_time = 0;
+    for (size_t const nt : thread_counts) {
+      size_t check_sum = 0;
+      double const begin = omp_get_wtime();
+      if (use_batch) {
+        if constexpr (requires(std::span<const std::pair<size_t, size_t>> q,
+                               std::span<size_t> out) {
+                        lce_ds.lce_batch(q, out);
+                      }) {
+#pragma omp parallel num_threads(nt)
+          {
+            size_t const t = omp_get_thread_num();
+            size_t const slice_size = num_pairs / nt;
+            size_t const begin_q = t * slice_size;
+            size_t const end_q =
+                (t == nt - 1) ? num_pairs : (t + 1) * slice_size;
+            lce_ds.lce_batch(
+                std::span<const std::pair<size_t, size_t>>(
+                    query_pairs.data() + begin_q, end_q - begin_q),
+                std::span<size_t>(results.data() + begin_q, end_q - begin_q));
+          }
+        }
+        for (size_t const result : results) {
+          check_sum += result;
+        }
+      } else {
+#pragma omp parallel for num_threads(nt) schedule(static) \
+    reduction(+ : check_sum)
+        for (size_t i = 0; i < num_pairs; ++i) {
+          check_sum += lce_ds.lce(queries[2 * i], queries[2 * i + 1]);
+        }
+      }
+      double const seconds = omp_get_wtime() - begin;
+      if (base_time == 0) {
+        base_time = seconds;
+      }
+
+      fmt::print("RESULT algo={}_par_queries", algo_name);
+      fmt::print(" text={}", text_path.filename().string());
+      fmt::print(" lce_range={}", lce_cur);
+      fmt::print(" q_size={}", num_pairs);
+      fmt::print(" q_mode={}", use_batch ? "batch" : "scalar");
+      fmt::print(" threads={}", nt);
+      fmt::print(" q_time={}", static_cast<size_t>(seconds * 1000));
+      fmt::print(" q_per_sec={:.0f}", seconds > 0 ? num_pairs / seconds : 0.0);
+      fmt::print(" speedup={:.2f}", seconds > 0 ? base_time / seconds : 0.0);
+      fmt::print(" check_sum={}", check_sum);
+      fmt::print("\n");
+    }
+  }
+
+  // Answer the queries of each lce range with lce_offline, which builds its
+  // own data structures for them. The time and memory include the
+  // construction.
+  template <typename lce_ds_type>
+  void benchmark_offline(std::string const& algo_name) {
+    for (size_t lce_cur = lce_from; lce_cur < lce_to; ++lce_cur) {
+      fmt::print("RESULT algo={}_offline", algo_name);
+      load_text();
+      fmt::print(" lce_range={}", lce_cur);
+      load_queries(lce_cur);
+      std::vector<std::pair<size_t, size_t>> query_pairs(queries.size() / 2);
+      for (size_t i = 0; i < query_pairs.size(); ++i) {
+        query_pairs[i] = {queries[2 * i], queries[2 * i + 1]};
+      }
+      std::vector<size_t> results(query_pairs.size());
+
+#ifdef ALX_BENCHMARK_SPACE
+      malloc_count_reset_peak();
+      size_t mem_before = malloc_count_current();
+#endif
+      fmt::print(" q_mode=offline");
+      alx::util::timer t;
+      lce_ds_type::lce_offline(text, query_pairs, results);
+      fmt::print(" threads={}", omp_get_max_threads());
+      fmt::print(" q_time={}", t.get());
+#ifdef ALX_BENCHMARK_SPACE
+      fmt::print(" q_mempeak={}", malloc_count_peak() - mem_before);
+#endif
+
+      size_t check_sum = 0;
+      for (size_t const result : results) {
+        check_sum += result;
+      }
+      fmt::print(" check_sum={}", check_sum);
+      fmt::print("\n");
+    }
+  }
+
   template <typename lce_ds_type>
   void run(std::string const& algo_name) {
     if (algorithm == "main") {
@@ -264,6 +463,16 @@ class benchmark {
       }
     }
 
+    if constexpr (requires(std::span<const std::pair<size_t, size_t>> q,
+                           std::span<size_t> out) {
+                    lce_ds_type::lce_offline(text, q, out);
+                  }) {
+      if (offline) {
+        benchmark_offline<lce_ds_type>(algo_name);
+        return;
+      }
+    }
+
     // Benchmark construction
     fmt::print("RESULT algo={}", algo_name);
 
@@ -277,6 +486,9 @@ class benchmark {
     }
 
     lce_ds_type lce_ds = benchmark_construction<lce_ds_type>();
+    if constexpr (requires { lce_ds_type::kernel_name(); }) {
+      fmt::print(" kernel={}", lce_ds_type::kernel_name());
+    }
     fmt::print("\n");
 
     // Benchmark queries
@@ -288,6 +500,7 @@ class benchmark {
       load_queries(lce_cur);
       benchmark_queries<lce_ds_type>(lce_ds);
       fmt::print("\n");
+      benchmark_parallel_queries<lce_ds_type>(lce_ds, algo_name, lce_cur);
       ++lce_cur;
     }
   }
@@ -329,6 +542,18 @@ int main(int argc, char** argv) {
       "to", b.lce_to,
       "Use only lce queries which return up to 2^{to}-1 with (default=21)");
 
+  cp.add_flag("batch", b.batch,
+              "Answer the queries with lce_batch, if the data structure "
+              "supports it.");
+  cp.add_flag("offline", b.offline,
+              "Answer all queries at once with lce_offline, if the data "
+              "structure supports it. This includes the construction.");
+  cp.add_string("threads", b.threads_list,
+                "Comma separated list of thread counts (e.g. 1,2,4,8). For "
+                "each of them, the queries are additionally answered in "
+                "parallel and queries/sec and speedup (relative to the first "
+                "entry) are reported.");
+
   cp.add_string(
       'a', "algorithm", b.algorithm,
       fmt::format("Name of data structure which is benchmarked. Options: {}",
@@ -345,12 +570,25 @@ int main(int argc, char** argv) {
   b.run<lce_naive_std<>>("naive_std");
   b.run<lce_naive_wordwise<>>("naive_wordwise");
   b.run<lce_naive_wordwise_xor<>>("naive_wordwise_xor");
+  b.run<lce_naive_simd<>>("naive_simd");
 
   b.run<lce_fp<uint8_t, 64>>("fp64");
   b.run<lce_fp<uint8_t, 128>>("fp128");
   b.run<lce_fp<uint8_t, 256>>("fp256");
   b.run<lce_fp<uint8_t, 512>>("fp512");
   b.run<lce_fp<uint8_t, (size_t{1} << 40)>>("fp_unlimited");
+  b.run<lce_fp<uint8_t, 64, false>>("fp64_sep");
+  b.run<lce_fp<uint8_t, 256, false>>("fp256_sep");
+  b.run<lce_fp_mersenne<uint8_t, 64>>("fp_mersenne64");
+  b.run<lce_fp_mersenne<uint8_t, 128>>("fp_mersenne128");
+  b.run<lce_fp_mersenne<uint8_t, 256>>("fp_mersenne256");
+  b.run<lce_fp_mersenne<uint8_t, 512>>("fp_mersenne512");
+  b.run<lce_fp_sampled<uint8_t, 64>>("fp_sampled64");
+  b.run<lce_fp_sampled<uint8_t, 128>>("fp_sampled128");
+  b.run<lce_fp_sampled<uint8_t, 256>>("fp_sampled256");
+  b.run<lce_fp_sampled<uint8_t, 512>>("fp_sampled512");
+  b.run<lce_fp_sampled<uint8_t, 256, 4>>("fp_sampled256_k4");
+  b.run<lce_fp_sampled<uint8_t, 256, 64>>("fp_sampled256_k64");
   b.run<rklce::lce_rk_prezza>("rk-prezza");
 
   using gsaca_lyndon::uint40_t;
@@ -362,6 +600,9 @@ int main(int argc, char** argv) {
   b.run<lce_sss_naive<uint8_t, 512, uint40_t, true>>("sss_naive512pl");
   b.run<lce_sss_naive<uint8_t, 1024, uint40_t, true>>("sss_naive1024pl");
   b.run<lce_sss_naive<uint8_t, 2048, uint40_t, true>>("sss_naive2048pl");
+  // The same data structures with 64-bit fingerprints.
+  b.run<lce_sss_naive<uint8_t, 512, uint40_t, false, true>>("sss_naive512c");
+  b.run<lce_sss_naive<uint8_t, 1024, uint40_t, false, true>>("sss_naive1024c");
 
   b.run<lce_sss_noss<uint8_t, 256, uint40_t, false>>("sss_noss256");
   b.run<lce_sss_noss<uint8_t, 512, uint40_t, false>>("sss_noss512");
@@ -371,6 +612,8 @@ int main(int argc, char** argv) {
   b.run<lce_sss_noss<uint8_t, 512, uint40_t, true>>("sss_noss512pl");
   b.run<lce_sss_noss<uint8_t, 1024, uint40_t, true>>("sss_noss1024pl");
   b.run<lce_sss_noss<uint8_t, 2048, uint40_t, true>>("sss_noss2048pl");
+  b.run<lce_sss_noss<uint8_t, 512, uint40_t, false, true>>("sss_noss512c");
+  b.run<lce_sss_noss<uint8_t, 1024, uint40_t, false, true>>("sss_noss1024c");
 
   b.run<lce_sss<uint8_t, 256, uint40_t, false>>("sss256");
   b.run<lce_sss<uint8_t, 512, uint40_t, false>>("sss512");
@@ -382,6 +625,35 @@ int main(int argc, char** argv) {
   b.run<lce_sss<uint8_t, 2048, uint40_t, true>>("sss2048pl");
 
   b.run<lce_classic<uint8_t, uint40_t>>("classic");
+  b.run<lce_classic_compressed<uint8_t, uint40_t>>("classic_compressed");
+  b.run<lce_classic_compressed<uint8_t, uint40_t, 4>>("classic_compressed4");
+  b.run<lce_classic_compressed<uint8_t, uint40_t, 1>>(
+      "classic_compressed_isa");
+
+  // The same data structures with suffix arrays built by libsais.
+  using alx::suffix_sort::libsais_backend;
+  b.run<lce_classic<uint8_t, uint40_t, libsais_backend>>("classic_libsais");
+  b.run<lce_classic_compressed<uint8_t, uint40_t, 8, 64, libsais_backend>>(
+      "classic_compressed_libsais");
+  b.run<lce_sss<uint8_t, 512, uint40_t, false, libsais_backend>>(
+      "sss512_libsais");
+  b.run<lce_sss<uint8_t, 512, uint40_t, true, libsais_backend>>(
+      "sss512pl_libsais");
+
+  // The LCP arrays are permuted from the PLCP arrays.
+  using alx::suffix_sort::gsaca_backend;
+  using alx::suffix_sort::with_phi_lcp;
+  b.run<lce_classic<uint8_t, uint40_t, with_phi_lcp<gsaca_backend>>>(
+      "classic_phi");
+  b.run<lce_classic<uint8_t, uint40_t, with_phi_lcp<libsais_backend>>>(
+      "classic_libsais_phi");
+  b.run<lce_sss<uint8_t, 512, uint40_t, false, with_phi_lcp<gsaca_backend>>>(
+      "sss512_phi");
+
+  // The LCP array is queried with a succinct RMQ.
+  b.run<lce_classic<uint8_t, uint40_t, gsaca_backend,
+                    alx::rmq::rmq_succinct<uint40_t, uint40_t>>>(
+      "classic_succinct");
   #ifdef ALX_BUILD_LCE_SDSL
     b.run<lce_sdsl_cst>("sdsl_cst");
   #endif
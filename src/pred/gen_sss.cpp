@@ -9,11 +9,13 @@
 #include <fmt/core.h>
 #include <fmt/ranges.h>
 
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <gsaca-double-sort/uint_types.hpp>  // uint40_t
 #include <tlx/cmdline_parser.hpp>
 
-#include "rolling_hash/string_synchronizing_set.hpp"
-#include "util/io.hpp"
+#include "rolling_hash/sss_stream.hpp"
 
 namespace fs = std::filesystem;
 
@@ -26,14 +28,43 @@ struct hash<gsaca_lyndon::uint40_t> {
 };
 }  // namespace std
 
+// The text is streamed in chunks, so that only a chunk of the text and its
+// sss are kept in memory.
+template <uint64_t tau>
+bool write_sss(fs::path const& text_path, fs::path const& output_path,
+               size_t chunk_size, bool write_fps) {
+  using gsaca_lyndon::uint40_t;
+  int const fd = open(text_path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    fmt::print("Text file {} could not be opened.\n", text_path.string());
+    return false;
+  }
+  fs::path fps_path;
+  if (write_fps) {
+    fps_path = output_path;
+    fps_path += ".fps";
+  }
+  alx::rolling_hash::sss_stream<uint40_t, tau> sss(
+      fd, fs::file_size(text_path), chunk_size);
+  alx::rolling_hash::sss_file_sink<uint40_t> sink(output_path, fps_path);
+  bool const success = sink.good() && sss.build(sink, write_fps);
+  close(fd);
+  if (!sink.close() || !success) {
+    fmt::print("Could not write {}.\n", output_path.string());
+    return false;
+  }
+  return true;
+}
+
 int main(int argc, char** argv) {
   std::vector<std::string> algorithms{"all", "sss256", "sss512", "sss1024",
                                       "sss2048"};
 
   std::filesystem::path text_path;
-  std::vector<uint8_t> text;
   std::filesystem::path output_path;
   std::string algorithm{"sss512"};
+  uint64_t chunk_size = uint64_t{1} << 28;
+  bool write_fps = false;
 
   tlx::CmdlineParser cp;
   cp.set_description(
@@ -47,6 +78,10 @@ int main(int argc, char** argv) {
       fmt::format("Name of data structure which is benchmarked. Options: {}",
                   algorithms));
   cp.add_path('o', "output_folder", output_path, "The output folder.");
+  cp.add_bytes('c', "chunk_size", chunk_size,
+               "Number of text positions that are processed at once.");
+  cp.add_flag('f', "fps", write_fps,
+              "Also write the fingerprints of the 3tau-windows.");
   if (!cp.process(argc, argv)) {
     std::exit(EXIT_FAILURE);
   }
@@ -71,9 +106,6 @@ int main(int argc, char** argv) {
     }
   }
 
-  text = alx::util::load_vector<uint8_t>(text_path);
-  using gsaca_lyndon::uint40_t;
-
   if(output_path == "") {
     output_path = text_path;
     output_path += ".sss";
@@ -84,23 +116,27 @@ int main(int argc, char** argv) {
   
   if (algorithm == "sss256" || algorithm == "all") {
     output_path.replace_extension("sss256");
-    alx::rolling_hash::sss<uint40_t, 256> sss(text);
-    alx::util::write_vector(output_path, sss.get_sss());
+    if (!write_sss<256>(text_path, output_path, chunk_size, write_fps)) {
+      return -1;
+    }
   }
   if (algorithm == "sss512" || algorithm == "all") {
     output_path.replace_extension("sss512");
-    alx::rolling_hash::sss<uint40_t, 512> sss(text);
-    alx::util::write_vector(output_path, sss.get_sss());
+    if (!write_sss<512>(text_path, output_path, chunk_size, write_fps)) {
+      return -1;
+    }
   }
   if (algorithm == "sss1024" || algorithm == "all") {
     output_path.replace_extension(".sss1024");
-    alx::rolling_hash::sss<uint40_t, 1024> sss(text);
-    alx::util::write_vector(output_path, sss.get_sss());
+    if (!write_sss<1024>(text_path, output_path, chunk_size, write_fps)) {
+      return -1;
+    }
   }
   if (algorithm == "sss2048" || algorithm == "all") {
     output_path.replace_extension(".sss2048");
-    alx::rolling_hash::sss<uint40_t, 2048> sss(text);
-    alx::util::write_vector(output_path, sss.get_sss());
+    if (!write_sss<2048>(text_path, output_path, chunk_size, write_fps)) {
+      return -1;
+    }
   }
   return 0;
 }
@@ -0,0 +1,303 @@
+/*******************************************************************************
+ * src/rmq/benchmark.cpp
+ *
+ * Copyright (C) 2026 Alexander Herlez <alexander.herlez@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <fmt/core.h>
+#include <fmt/ranges.h>
+#ifdef ALX_BENCHMARK_SPACE
+#include <malloc_count/malloc_count.h>
+#endif
+
+#include <assert.h>
+#include <omp.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <gsaca-double-sort/uint_types.hpp>  // uint40_t
+#include <iostream>
+#include <limits>
+#include <random>
+#include <tlx/cmdline_parser.hpp>
+#include <vector>
+
+#include "rmq/rmq_bit.hpp"
+#include "rmq/rmq_n.hpp"
+#include "rmq/rmq_naive.hpp"
+#include "rmq/rmq_nlgn.hpp"
+#include "rmq/rmq_succinct.hpp"
+#include "suffix_sort/suffix_array_construction.hpp"
+#include "util/io.hpp"
+#include "util/thread_list.hpp"
+#include "util/timer.hpp"
+
+namespace fs = std::filesystem;
+
+std::vector<std::string> algorithms{"all", "naive", "nlgn", "n",
+                                    "bit", "succinct"};
+
+class benchmark {
+ public:
+  typedef uint32_t t_data_type;
+
+  // The data is the LCP array of text_path, the LCP array stored in lcp_path
+  // (5 bytes per entry, as read by gen_queries) or random integers.
+  fs::path text_path;
+  fs::path lcp_path;
+  std::vector<t_data_type> data;
+  std::string data_name;
+  size_t data_size = 100'000'000;
+  size_t max_value = std::numeric_limits<t_data_type>::max();
+
+  // Queries of range {k} have lengths in [2^k, 2^{k+1}).
+  std::vector<std::pair<size_t, size_t>> queries;
+  size_t num_queries = 1'000'000;
+  size_t range_from = 0;
+  // Without --to, the ranges go up to log n.
+  size_t range_to = std::numeric_limits<size_t>::max();
+
+  std::string algorithm = "all";
+  std::string threads_list;
+  std::vector<size_t> thread_counts;
+
+  bool check_parameters() {
+    // Check data
+    if (!text_path.empty() && !lcp_path.empty()) {
+      fmt::print("Use either a text or an LCP array.\n");
+      return false;
+    }
+    for (fs::path const& path : {text_path, lcp_path}) {
+      if (!path.empty() &&
+          (!fs::is_regular_file(path) || fs::file_size(path) == 0)) {
+        fmt::print("File {} is empty or does not exist.\n", path.string());
+        return false;
+      }
+    }
+    if (!text_path.empty() &&
+        fs::file_size(text_path) > std::numeric_limits<t_data_type>::max()) {
+      fmt::print("Text file {} is too large.\n", text_path.string());
+      return false;
+    }
+    if (text_path.empty() && lcp_path.empty() && data_size == 0) {
+      fmt::print("The data must not be empty.\n");
+      return false;
+    }
+
+    // Check thread counts
+    if (!alx::util::parse_thread_list(threads_list, thread_counts)) {
+      fmt::print("Invalid thread list {}.\n", threads_list);
+      return false;
+    }
+
+    // Check algorithm
+    if (std::find(algorithms.begin(), algorithms.end(), algorithm) ==
+        algorithms.end()) {
+      fmt::print("Algorithm {} is not specified.\n Use one of {}\n", algorithm,
+                 algorithms);
+      return false;
+    }
+    return true;
+  }
+
+  void load_data() {
+    alx::util::timer t;
+    if (!text_path.empty()) {
+      std::vector<uint8_t> text = alx::util::load_vector<uint8_t>(text_path);
+      std::vector<t_data_type> sa =
+          alx::suffix_sort::suffix_array<t_data_type>(text.data(),
+                                                      text.size());
+      std::vector<t_data_type> plcp =
+          alx::suffix_sort::plcp_array(text.data(), text.size(), sa);
+      data.resize(text.size());
+#pragma omp parallel for
+      for (size_t k = 0; k < data.size(); ++k) {
+        data[k] = plcp[sa[k]];
+      }
+      data_name = "lcp_" + text_path.filename().string();
+    } else if (!lcp_path.empty()) {
+      std::vector<gsaca_lyndon::uint40_t> lcp_5byte =
+          alx::util::load_vector<gsaca_lyndon::uint40_t>(lcp_path);
+      data.resize(lcp_5byte.size());
+      for (size_t k = 0; k < data.size(); ++k) {
+        uint64_t const value = lcp_5byte[k];
+        data[k] = std::min<uint64_t>(value, max_value);
+      }
+      data_name = lcp_path.filename().string();
+    } else {
+      data.resize(data_size);
+      std::mt19937_64 gen(1337);
+      std::uniform_int_distribution<t_data_type> distrib(0, max_value);
+      for (size_t i = 0; i < data_size; ++i) {
+        data[i] = distrib(gen);
+      }
+      data_name = fmt::format("random{}", max_value);
+    }
+    assert(data.size() != 0);
+    range_to = std::min<size_t>(range_to, std::bit_width(data.size()) - 1);
+    fmt::print(" data_time={}", t.get());
+  }
+
+  // Generate num_queries ranges whose lengths are uniformly distributed in
+  // [2^range, 2^{range+1}) intersected with [1, data.size()].
+  void load_queries(size_t range) {
+    alx::util::timer t;
+    queries.resize(num_queries);
+    std::mt19937_64 gen(7331 + range);
+    size_t const min_length = size_t{1} << range;
+    size_t const max_length = std::min((size_t{2} << range) - 1, data.size());
+    std::uniform_int_distribution<size_t> length_distrib(min_length,
+                                                         max_length);
+    for (size_t i = 0; i < num_queries; ++i) {
+      size_t const length = length_distrib(gen);
+      std::uniform_int_distribution<size_t> left_distrib(0,
+                                                         data.size() - length);
+      size_t const left = left_distrib(gen);
+      queries[i] = {left, left + length - 1};
+    }
+    fmt::print(" q_size={}", queries.size());
+    fmt::print(" q_gen_time={}", t.get());
+  }
+
+  template <typename rmq_ds_type>
+  rmq_ds_type benchmark_construction() {
+#ifdef ALX_BENCHMARK_SPACE
+    malloc_count_reset_peak();
+    size_t mem_before = malloc_count_current();
+#endif
+    alx::util::timer t;
+    rmq_ds_type rmq_ds(data);
+    fmt::print(" threads={}", omp_get_max_threads());
+    fmt::print(" c_time={}", t.get());
+    if constexpr (requires { rmq_ds.bits_per_element(); }) {
+      fmt::print(" bits_per_element={}", rmq_ds.bits_per_element());
+    }
+#ifdef ALX_BENCHMARK_SPACE
+    fmt::print(" c_mem={}", malloc_count_current() - mem_before);
+    fmt::print(" c_mempeak={}", malloc_count_peak() - mem_before);
+#endif
+    return rmq_ds;
+  }
+
+  template <typename rmq_ds_type>
+  void benchmark_queries(rmq_ds_type& rmq_ds) {
+    alx::util::timer t;
+    size_t check_sum = 0;
+    for (size_t i = 0; i < queries.size(); ++i) {
+      check_sum += rmq_ds.rmq(queries[i].first, queries[i].second);
+    }
+    fmt::print(" q_time={}", t.get());
+    fmt::print(" check_sum={}", check_sum);
+  }
+
+  // Answer the generated queries once for each number of threads in
+  // thread_counts against the same shared data structure.
+  template <typename rmq_ds_type>
+  void benchmark_parallel_queries(rmq_ds_type& rmq_ds,
+                                  std::string const& algo_name, size_t range) {
+    double base_time = 0;
+    for (size_t const nt : thread_counts) {
+      size_t check_sum = 0;
+      double const begin = omp_get_wtime();
+#pragma omp parallel for num_threads(nt) schedule(static) \
+    reduction(+ : check_sum)
+      for (size_t i = 0; i < queries.size(); ++i) {
+        check_sum += rmq_ds.rmq(queries[i].first, queries[i].second);
+      }
+      double const seconds = omp_get_wtime() - begin;
+      if (base_time == 0) {
+        base_time = seconds;
+      }
+
+      fmt::print("RESULT algo={}_par_queries", algo_name);
+      fmt::print(" data={}", data_name);
+      fmt::print(" range={}", range);
+      fmt::print(" q_size={}", queries.size());
+      fmt::print(" threads={}", nt);
+      fmt::print(" q_time={}", static_cast<size_t>(seconds * 1000));
+      fmt::print(" q_per_sec={:.0f}",
+                 seconds > 0 ? queries.size() / seconds : 0.0);
+      fmt::print(" speedup={:.2f}", seconds > 0 ? base_time / seconds : 0.0);
+      fmt::print(" check_sum={}", check_sum);
+      fmt::print("\n");
+    }
+  }
+
+ public:
+  template <typename rmq_ds_type>
+  void run(std::string const& algo_name) {
+    if (algo_name != algorithm && algorithm != "all") {
+      return;
+    }
+
+    // Construction
+    fmt::print("RESULT algo={}", algo_name);
+    if (data.empty()) {
+      load_data();
+    }
+    fmt::print(" data={}", data_name);
+    fmt::print(" data_size={}", data.size());
+    rmq_ds_type rmq_ds = benchmark_construction<rmq_ds_type>();
+    fmt::print("\n");
+
+    // Queries
+    for (size_t range = range_from; range <= range_to; ++range) {
+      fmt::print("RESULT algo={}_queries", algo_name);
+      fmt::print(" data={}", data_name);
+      fmt::print(" range={}", range);
+      load_queries(range);
+      benchmark_queries<rmq_ds_type>(rmq_ds);
+      fmt::print("\n");
+      benchmark_parallel_queries<rmq_ds_type>(rmq_ds, algo_name, range);
+    }
+  }
+};
+
+int main(int argc, char** argv) {
+  benchmark b;
+  tlx::CmdlineParser cp;
+  cp.set_description(
+      "This program measures construction time and query time for several "
+      "range minimum query data structures over LCP arrays or random "
+      "integers.");
+  cp.set_author("Alexander Herlez <alexander.herlez@tu-dortmund.de>");
+  cp.add_path("text_path", b.text_path,
+              "Query the LCP array of this text (at most 4 GiB).");
+  cp.add_path("lcp_path", b.lcp_path,
+              "Query this LCP array with 5 bytes per entry.");
+  cp.add_bytes('n', "data_size", b.data_size,
+               "Number of random integers if no text or LCP array is given "
+               "(default=100,000,000).");
+  cp.add_bytes('m', "max_value", b.max_value,
+               "The random integers are drawn uniformly from [0, max_value].");
+  cp.add_bytes('q', "num_queries", b.num_queries,
+               "Number of queries per range (default=1,000,000).");
+  cp.add_bytes("from", b.range_from,
+               "Use only ranges of length at least 2^{from} (default=0).");
+  cp.add_bytes("to", b.range_to,
+               "Use only ranges of length below 2^{to+1} (default=log n).");
+  cp.add_string("threads", b.threads_list,
+                "Comma separated list of thread counts (e.g. 1,2,4,8). For "
+                "each of them, the queries are additionally answered in "
+                "parallel and queries/sec and speedup (relative to the first "
+                "entry) are reported.");
+  cp.add_string(
+      'a', "algorithm", b.algorithm,
+      fmt::format("Name of data structure which is benchmarked. Options: {}",
+                  algorithms));
+
+  if (!cp.process(argc, argv)) {
+    std::exit(EXIT_FAILURE);
+  }
+  if (!b.check_parameters()) {
+    return -1;
+  }
+
+  b.run<alx::rmq::rmq_naive<uint32_t>>("naive");
+  b.run<alx::rmq::rmq_nlgn<uint32_t>>("nlgn");
+  b.run<alx::rmq::rmq_n<uint32_t>>("n");
+  b.run<alx::rmq::rmq_bit<uint32_t>>("bit");
+  b.run<alx::rmq::rmq_succinct<uint32_t>>("succinct");
+}
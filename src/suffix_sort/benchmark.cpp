@@ -14,25 +14,36 @@
 
 #include <omp.h>
 
+#include <algorithm>
 #include <filesystem>
 #include <iostream>
+#include <span>
 #include <string>
 #include <tlx/cmdline_parser.hpp>
 #include <vector>
 
 #include "lce/lce_fp.hpp"
+#include "lce/lce_fp_sampled.hpp"
 #include "lce/lce_memcmp.hpp"
 #include "lce/lce_naive.hpp"
+#include "lce/lce_naive_simd.hpp"
 #include "lce/lce_naive_std.hpp"
 #include "lce/lce_naive_wordwise.hpp"
+#include "lce/lce_sss.hpp"
+#include "suffix_sort/sparse_suffix_sort.hpp"
 #include "util/io.hpp"
+#include "util/thread_list.hpp"
 #include "util/timer.hpp"
 
 namespace fs = std::filesystem;
 
 std::vector<std::string> algorithms{
-    "all",  "naive", "naive_std", "naive_wordwise", "naive_memcmp", "fp8",
-    "fp16", "fp32",  "fp64",      "fp128",          "fp256",        "fp512"};
+    "all",          "naive",         "naive_std",     "naive_wordwise",
+    "naive_simd",   "naive_memcmp",  "fp8",           "fp16",
+    "fp32",         "fp64",          "fp128",         "fp256",
+    "fp512",        "fp_sampled8",   "fp_sampled16",  "fp_sampled32",
+    "fp_sampled64", "fp_sampled128", "fp_sampled256", "fp_sampled512",
+    "sss512"};
 
 class benchmark {
  public:
@@ -43,6 +54,10 @@ class benchmark {
   size_t sample_rate{1};
 
   std::string algorithm = "naive";
+  bool pivot_sort = false;
+  bool lcp = false;
+  std::string threads_list;
+  std::vector<size_t> thread_counts;
 
   bool check_parameters() {
     // Check text path
@@ -52,6 +67,12 @@ class benchmark {
       return false;
     }
 
+    // Check thread counts
+    if (!alx::util::parse_thread_list(threads_list, thread_counts)) {
+      fmt::print("Invalid thread list {}.\n", threads_list);
+      return false;
+    }
+
     // Check algorithm flag
     if (std::find(algorithms.begin(), algorithms.end(), algorithm) ==
         algorithms.end()) {
@@ -96,24 +117,75 @@ class benchmark {
     for (size_t i{sample_rate}; i < text.size(); i += sample_rate) {
       sa.push_back(i);
     }
-    assert(sa.size() == text.size() / sample_rate);
+    assert(sa.size() == (text.size() - 1) / sample_rate);
     fmt::print(" sample_rate={}", sample_rate);
     fmt::print(" sa_size={}", sa.size());
     fmt::print(" sa_load_time={}", t.get());
   }
 
+  // Sort the suffixes with quicksort. Each pivot is compared with its whole
+  // range by one call of is_leq_suffix_many.
   template <typename lce_ds_type>
-  void benchmark_ss() {
+  static void quicksort_pivot(lce_ds_type const& lce_ds,
+                              std::span<size_t> suffixes,
+                              std::vector<uint8_t>& is_leq) {
+    while (suffixes.size() > 16) {
+      std::swap(suffixes[suffixes.size() / 2], suffixes.back());
+      size_t const pivot = suffixes.back();
+      std::span<size_t> const others = suffixes.first(suffixes.size() - 1);
+      lce_ds.is_leq_suffix_many(pivot, others, is_leq);
+
+      // Move the suffixes smaller than the pivot to the front.
+      size_t mid = 0;
+      for (size_t k = 0; k < others.size(); ++k) {
+        if (is_leq[k]) {
+          std::swap(others[k], others[mid++]);
+        }
+      }
+      std::swap(suffixes[mid], suffixes.back());
+
+      // Recurse into the smaller part.
+      if (mid < suffixes.size() - mid - 1) {
+        quicksort_pivot(lce_ds, suffixes.first(mid), is_leq);
+        suffixes = suffixes.subspan(mid + 1);
+      } else {
+        quicksort_pivot(lce_ds, suffixes.subspan(mid + 1), is_leq);
+        suffixes = suffixes.first(mid);
+      }
+    }
+    std::sort(suffixes.begin(), suffixes.end(), [&lce_ds](size_t i, size_t j) {
+      return lce_ds.is_leq_suffix(i, j);
+    });
+  }
+
+  template <typename lce_ds_type>
+  void benchmark_ss(std::string const& algo_name) {
     if (sa.empty()) {
+      fmt::print("\n");
       return;
     }
 
     alx::util::timer t;
     lce_ds_type lce_ds = benchmark_construction<lce_ds_type>();
 
-    std::sort(sa.begin(), sa.end(), [&lce_ds](size_t i, size_t j) {
-      return lce_ds.is_leq_suffix(i, j);
-    });
+    bool sorted = false;
+    if constexpr (requires(std::span<const size_t> others,
+                           std::span<uint8_t> out) {
+                    lce_ds.is_leq_suffix_many(0, others, out);
+                  }) {
+      if (pivot_sort) {
+        fmt::print(" sort=pivot");
+        std::vector<uint8_t> is_leq(sa.size());
+        quicksort_pivot(lce_ds, std::span<size_t>(sa), is_leq);
+        sorted = true;
+      }
+    }
+    if (!sorted) {
+      fmt::print(" sort=std");
+      std::sort(sa.begin(), sa.end(), [&lce_ds](size_t i, size_t j) {
+        return lce_ds.is_leq_suffix(i, j);
+      });
+    }
 
     fmt::print(" ss_time={}", t.get());
 
@@ -122,6 +194,63 @@ class benchmark {
       check_sum += sa[i - 1] - sa[i];
     }
     fmt::print(" check_sum={}", check_sum);
+    fmt::print("\n");
+
+    benchmark_parallel_ss<lce_ds_type>(lce_ds, algo_name);
+  }
+
+  // Sort the samples with the parallel sparse suffix sorter once for each
+  // number of threads in thread_counts.
+  template <typename lce_ds_type>
+  void benchmark_parallel_ss(lce_ds_type const& lce_ds,
+                             std::string const& algo_name) {
+    double base_time = 0;
+    for (size_t const nt : thread_counts) {
+      std::vector<size_t> positions;
+      positions.reserve(sa.size());
+      for (size_t i{sample_rate}; i < text.size(); i += sample_rate) {
+        positions.push_back(i);
+      }
+
+      double const begin = omp_get_wtime();
+      std::vector<size_t> const ssa =
+          alx::suffix_sort::sparse_suffix_array(lce_ds, std::move(positions),
+                                                nt);
+      double const seconds = omp_get_wtime() - begin;
+      if (base_time == 0) {
+        base_time = seconds;
+      }
+
+      fmt::print("RESULT algo={}_par_ss", algo_name);
+      fmt::print(" text={}", text_path.filename().string());
+      fmt::print(" sample_rate={}", sample_rate);
+      fmt::print(" sa_size={}", ssa.size());
+      fmt::print(" threads={}", nt);
+      fmt::print(" ss_time={}", static_cast<size_t>(seconds * 1000));
+      fmt::print(" speedup={:.2f}", seconds > 0 ? base_time / seconds : 0.0);
+
+      if constexpr (requires { lce_ds.lce(0, 0); }) {
+        if (lcp) {
+          double const lcp_begin = omp_get_wtime();
+          std::vector<size_t> const lcp_array =
+              alx::suffix_sort::sparse_lcp_array(lce_ds, ssa, nt);
+          fmt::print(" lcp_time={}",
+                     static_cast<size_t>((omp_get_wtime() - lcp_begin) * 1000));
+          size_t lcp_sum = 0;
+          for (size_t const l : lcp_array) {
+            lcp_sum += l;
+          }
+          fmt::print(" lcp_sum={}", lcp_sum);
+        }
+      }
+
+      size_t check_sum = 0;
+      for (size_t i{1}; i < ssa.size(); ++i) {
+        check_sum += ssa[i - 1] - ssa[i];
+      }
+      fmt::print(" check_sum={}", check_sum);
+      fmt::print("\n");
+    }
   }
 
   template <typename lce_ds_type>
@@ -134,8 +263,7 @@ class benchmark {
     fmt::print("RESULT algo={}", algo_name);
     load_text();
     load_sa();
-    benchmark_ss<lce_ds_type>();
-    fmt::print("\n");
+    benchmark_ss<lce_ds_type>(algo_name);
   }
 };
 
@@ -152,6 +280,19 @@ int main(int argc, char** argv) {
   cp.add_bytes('s', "sample_rate", b.sample_rate,
                "Sort every s'th sample. (default = 1)");
 
+  cp.add_flag("pivot", b.pivot_sort,
+              "Sort with a quicksort that compares each pivot with all "
+              "suffixes of its range at once, if the data structure supports "
+              "it.");
+
+  cp.add_string("threads", b.threads_list,
+                "Comma separated list of thread counts (e.g. 1,2,4,8). For "
+                "each of them, the samples are additionally sorted with the "
+                "parallel sparse suffix sorter and the speedup (relative to "
+                "the first entry) is reported.");
+  cp.add_flag("lcp", b.lcp,
+              "Also compute the sparse LCP array in the parallel runs.");
+
   cp.add_string('a', "algorithm", b.algorithm,
                 fmt::format("Algorithm for string sorting: {}", algorithms));
 
@@ -166,6 +307,7 @@ int main(int argc, char** argv) {
   b.run<alx::lce::lce_naive<>>("naive");
   b.run<alx::lce::lce_naive_std<>>("naive_std");
   b.run<alx::lce::lce_naive_wordwise<>>("naive_wordwise");
+  b.run<alx::lce::lce_naive_simd<>>("naive_simd");
   b.run<alx::lce::lce_memcmp>("naive_memcmp");
 
   b.run<alx::lce::lce_fp<uint8_t, 8>>("fp8");
@@ -176,5 +318,13 @@ int main(int argc, char** argv) {
   b.run<alx::lce::lce_fp<uint8_t, 256>>("fp256");
   b.run<alx::lce::lce_fp<uint8_t, 512>>("fp512");
 
-  // b.run<alx::lce::lce_sss<uint8_t, 512>>("fp512");
+  b.run<alx::lce::lce_fp_sampled<uint8_t, 8>>("fp_sampled8");
+  b.run<alx::lce::lce_fp_sampled<uint8_t, 16>>("fp_sampled16");
+  b.run<alx::lce::lce_fp_sampled<uint8_t, 32>>("fp_sampled32");
+  b.run<alx::lce::lce_fp_sampled<uint8_t, 64>>("fp_sampled64");
+  b.run<alx::lce::lce_fp_sampled<uint8_t, 128>>("fp_sampled128");
+  b.run<alx::lce::lce_fp_sampled<uint8_t, 256>>("fp_sampled256");
+  b.run<alx::lce::lce_fp_sampled<uint8_t, 512>>("fp_sampled512");
+
+  b.run<alx::lce::lce_sss<uint8_t, 512>>("sss512");
 }
\ No newline at end of file
@@ -7,14 +7,21 @@
  ******************************************************************************/
 
 #include <gtest/gtest.h>
+#include <omp.h>
 
+#include <gsaca-double-sort/uint_types.hpp>  // uint40_t
 #include <limits>
 #include <numeric>
+#include <random>
 
 #include "lce/lce_classic.hpp"
+#include "lce/lce_classic_compressed.hpp"
 #include "lce/lce_fp.hpp"
+#include "lce/lce_fp_mersenne.hpp"
+#include "lce/lce_fp_sampled.hpp"
 #include "lce/lce_memcmp.hpp"
 #include "lce/lce_naive.hpp"
+#include "lce/lce_naive_simd.hpp"
 #include "lce/lce_naive_std.hpp"
 #include "lce/lce_naive_wordwise.hpp"
 #include "lce/lce_naive_wordwise_xor.hpp"
@@ -22,6 +29,8 @@
 #include "lce/lce_sss.hpp"
 #include "lce/lce_sss_naive.hpp"
 #include "lce/lce_sss_noss.hpp"
+#include "rmq/rmq_succinct.hpp"
+#include "test_texts.hpp"
 
 template <typename lce_ds_type>
 void test_empty_constructor() {
@@ -158,6 +167,245 @@ void test_retransform() {
   }
 }
 
+// Check an in-place fingerprinting data structure on a text that contains
+// blocks of only 0 or 0xFF bytes, against lce_naive. Afterwards the text must
+// be restored.
+template <typename lce_ds_type>
+void test_fp_extreme_blocks() {
+  typedef typename lce_ds_type::char_type char_typee;
+  std::mt19937_64 gen(42);
+  std::vector<char_typee> text(4096);
+  for (size_t i = 0; i < text.size(); ++i) {
+    size_t const block = i / 64;
+    text[i] = (block % 3 == 0)   ? char_typee(0xFF)
+              : (block % 3 == 1) ? char_typee(0)
+                                 : char_typee(gen() % 2 ? 0xFF : 0x1F);
+  }
+  std::vector<char_typee> const text_copy = text;
+
+  using naive = alx::lce::lce_naive<char_typee>;
+  {
+    lce_ds_type ds(text);
+    for (size_t i = 0; i < text_copy.size(); ++i) {
+      ASSERT_EQ(ds[i], text_copy[i]) << i;
+    }
+    for (size_t k = 0; k < 20000; ++k) {
+      size_t const i = gen() % text_copy.size();
+      size_t const j = gen() % text_copy.size();
+      ASSERT_EQ(ds.lce(i, j),
+                naive::lce(text_copy.data(), text_copy.size(), i, j))
+          << i << " " << j;
+      size_t const up_to = gen() % 300;
+      ASSERT_EQ(ds.lce_up_to(i, j, up_to),
+                naive::lce_up_to(text_copy.data(), text_copy.size(), i, j,
+                                 up_to))
+          << i << " " << j << " " << up_to;
+    }
+  }
+  EXPECT_EQ(text, text_copy);
+}
+
+// Check a fingerprinting data structure on a text where two characters at
+// distance 61 are swapped in a copy. Fingerprints modulo 2^61-1 with the base
+// 256 always collide on such strings, because 256^61 = 1 (mod 2^61-1).
+template <typename lce_ds_type>
+void test_fp_base_order() {
+  typedef typename lce_ds_type::char_type char_typee;
+  std::vector<char_typee> text(2048);
+  for (size_t k = 0; k < text.size(); ++k) {
+    text[k] = 'a' + (k * 7 % 13);
+  }
+  std::copy(text.begin(), text.begin() + 512, text.begin() + 1024);
+  std::swap(text[1024 + 64], text[1024 + 125]);
+
+  lce_ds_type ds(text);
+  EXPECT_EQ(ds.lce(0, 1024), 64);
+  EXPECT_EQ(ds.lce(1024, 0), 64);
+}
+
+// Check that the text is restored when several threads construct the data
+// structure and retransform the text.
+template <typename lce_ds_type>
+void test_retransform_parallel() {
+  typedef typename lce_ds_type::char_type char_typee;
+  auto [text, queries] = repetitive_text_and_queries<char_typee>(8008);
+  std::vector<char_typee> const text_copy = text;
+  int const max_threads = omp_get_max_threads();
+  for (int threads : {2, 3, 7}) {
+    omp_set_num_threads(threads);
+    lce_ds_type ds(text);
+    for (size_t k = 0; k < 100; ++k) {
+      auto const [i, j] = queries[k];
+      ASSERT_EQ(ds.lce(i, j), alx::lce::lce_naive<char_typee>::lce(
+                                  text_copy.data(), text_copy.size(), i, j));
+    }
+    ds.retransform_text();
+    ASSERT_EQ(text, text_copy) << threads;
+  }
+  omp_set_num_threads(max_threads);
+}
+
+// Check that the data structure never changes the text, which is only
+// available through a const reference.
+template <typename lce_ds_type>
+void test_read_only() {
+  typedef typename lce_ds_type::char_type char_typee;
+  auto [text, queries] = repetitive_text_and_queries<char_typee>(8000);
+  std::vector<char_typee> const& const_text = text;
+  std::vector<char_typee> const text_copy = text;
+  {
+    lce_ds_type ds(const_text);
+    EXPECT_EQ(text, text_copy);
+    for (auto const [i, j] : queries) {
+      ASSERT_EQ(ds.lce(i, j), alx::lce::lce_naive<char_typee>::lce(
+                                  text_copy.data(), text_copy.size(), i, j))
+          << i << " " << j;
+    }
+    lce_ds_type moved(std::move(ds));
+    EXPECT_EQ(moved.lce(0, 1), alx::lce::lce_naive<char_typee>::lce(
+                                   text_copy.data(), text_copy.size(), 0, 1));
+  }
+  EXPECT_EQ(text, text_copy);
+}
+
+template <typename lce_ds_type>
+void test_batch() {
+  typedef typename lce_ds_type::char_type char_typee;
+  auto [text, queries] = repetitive_text_and_queries<char_typee>(8000);
+  std::vector<size_t> expected(queries.size());
+  for (size_t k = 0; k < queries.size(); ++k) {
+    expected[k] = alx::lce::lce_naive<char_typee>::lce(
+        text.data(), text.size(), queries[k].first, queries[k].second);
+  }
+
+  lce_ds_type ds(text);
+  std::vector<size_t> result(queries.size());
+  ds.lce_batch(queries, result);
+  for (size_t k = 0; k < queries.size(); ++k) {
+    ASSERT_EQ(result[k], expected[k])
+        << queries[k].first << " " << queries[k].second;
+  }
+}
+
+template <typename lce_ds_type>
+void test_offline() {
+  typedef typename lce_ds_type::char_type char_typee;
+  auto [text, queries] = repetitive_text_and_queries<char_typee>(8000);
+  std::vector<size_t> result(queries.size());
+  lce_ds_type::lce_offline(text, queries, result);
+  for (size_t k = 0; k < queries.size(); ++k) {
+    ASSERT_EQ(result[k],
+              alx::lce::lce_naive<char_typee>::lce(
+                  text.data(), text.size(), queries[k].first,
+                  queries[k].second))
+        << queries[k].first << " " << queries[k].second;
+  }
+}
+
+template <typename lce_ds_type>
+void test_concurrent() {
+  typedef typename lce_ds_type::char_type char_typee;
+  auto [text, queries] = repetitive_text_and_queries<char_typee>(8000);
+  std::vector<char_typee> const text_copy = text;
+
+  lce_ds_type ds(text);
+  lce_ds_type const& const_ds = ds;
+  std::vector<size_t> lce(queries.size());
+  std::vector<std::pair<bool, size_t>> mismatch(queries.size());
+  std::vector<uint8_t> is_leq(queries.size());
+#pragma omp parallel for num_threads(4)
+  for (size_t k = 0; k < queries.size(); ++k) {
+    auto const [i, j] = queries[k];
+    lce[k] = const_ds.lce(i, j);
+    mismatch[k] = const_ds.lce_mismatch(i, j);
+    if (i != j) {
+      is_leq[k] = const_ds.is_leq_suffix(i, j);
+    }
+  }
+
+  using naive = alx::lce::lce_naive<char_typee>;
+  for (size_t k = 0; k < queries.size(); ++k) {
+    auto const [i, j] = queries[k];
+    ASSERT_EQ(lce[k], naive::lce(text_copy.data(), text_copy.size(), i, j))
+        << i << " " << j;
+    ASSERT_EQ(mismatch[k], naive::lce_mismatch(text_copy.data(),
+                                               text_copy.size(), i, j))
+        << i << " " << j;
+    if (i != j) {
+      ASSERT_EQ(is_leq[k], naive::is_leq_suffix(text_copy.data(),
+                                                text_copy.size(), i, j))
+          << i << " " << j;
+    }
+  }
+}
+
+// Check lce_many and is_leq_suffix_many for several pivots against lce_naive.
+template <typename lce_ds_type>
+void test_many() {
+  typedef typename lce_ds_type::char_type char_typee;
+  auto [text, queries] = repetitive_text_and_queries<char_typee>(8000);
+  std::vector<char_typee> const text_copy = text;
+  std::vector<size_t> others(queries.size());
+  for (size_t k = 0; k < queries.size(); ++k) {
+    others[k] = queries[k].second;
+  }
+  std::vector<size_t> lce(others.size());
+  std::vector<uint8_t> is_leq(others.size());
+
+  using naive = alx::lce::lce_naive<char_typee>;
+  lce_ds_type ds(text);
+  for (size_t p = 0; p < queries.size(); p += 50) {
+    size_t const pivot = queries[p].first;
+    ds.lce_many(pivot, others, lce);
+    for (size_t k = 0; k < others.size(); ++k) {
+      ASSERT_EQ(lce[k], naive::lce(text_copy.data(), text_copy.size(), pivot,
+                                   others[k]))
+          << pivot << " " << others[k];
+    }
+    std::erase(others, pivot);
+    ds.is_leq_suffix_many(pivot, others, is_leq);
+    for (size_t k = 0; k < others.size(); ++k) {
+      ASSERT_EQ(is_leq[k], naive::is_leq_suffix(text_copy.data(),
+                                                text_copy.size(), others[k],
+                                                pivot))
+          << pivot << " " << others[k];
+    }
+  }
+}
+
+// Check compare_suffixes against lce_naive, including the mismatching
+// characters and suffixes that are prefixes of other suffixes.
+template <typename lce_ds_type>
+void test_compare() {
+  typedef typename lce_ds_type::char_type char_typee;
+  auto [text, queries] = repetitive_text_and_queries<char_typee>(8000);
+  std::fill(text.end() - 100, text.end(), 'a');
+  queries.emplace_back(text.size() - 10, text.size() - 50);
+  queries.emplace_back(text.size() - 50, text.size() - 10);
+  queries.emplace_back(7, 7);
+  std::vector<char_typee> const text_copy = text;
+
+  using naive = alx::lce::lce_naive<char_typee>;
+  lce_ds_type ds(text);
+  for (auto const [i, j] : queries) {
+    auto const [order, lce, char_i, char_j] = ds.compare_suffixes(i, j);
+    ASSERT_EQ(lce, naive::lce(text_copy.data(), text_copy.size(), i, j))
+        << i << " " << j;
+    if (i == j) {
+      ASSERT_TRUE(order == 0);
+      continue;
+    }
+    ASSERT_TRUE(order != 0);
+    ASSERT_EQ(order < 0, naive::is_leq_suffix(text_copy.data(),
+                                              text_copy.size(), i, j))
+        << i << " " << j;
+    if (std::max(i, j) + lce != text_copy.size()) {
+      ASSERT_EQ(char_i, text_copy[i + lce]) << i << " " << j;
+      ASSERT_EQ(char_j, text_copy[j + lce]) << i << " " << j;
+    }
+  }
+}
+
 TEST(LceNaive, All) {
   test_empty_constructor<alx::lce::lce_naive<uint8_t>>();
 
@@ -182,6 +430,8 @@ TEST(LceNaive, All) {
   test_variants<alx::lce::lce_naive<int64_t>>();
   test_variants<alx::lce::lce_naive<__uint128_t>>();
   test_variants<alx::lce::lce_naive<__int128_t>>();
+  test_compare<alx::lce::lce_naive<uint8_t>>();
+  test_compare<alx::lce::lce_naive<int8_t>>();
 }
 
 TEST(LceNaiveStd, All) {
@@ -208,6 +458,7 @@ TEST(LceNaiveStd, All) {
   test_variants<alx::lce::lce_naive_std<int64_t>>();
   test_variants<alx::lce::lce_naive_std<__uint128_t>>();
   test_variants<alx::lce::lce_naive_std<__int128_t>>();
+  test_compare<alx::lce::lce_naive_std<uint8_t>>();
 }
 
 TEST(LceNaiveWordwise, All) {
@@ -234,6 +485,7 @@ TEST(LceNaiveWordwise, All) {
   test_variants<alx::lce::lce_naive_wordwise<int64_t>>();
   test_variants<alx::lce::lce_naive_wordwise<__uint128_t>>();
   test_variants<alx::lce::lce_naive_wordwise<__int128_t>>();
+  test_compare<alx::lce::lce_naive_wordwise<uint8_t>>();
 }
 
 TEST(LceNaiveWordwiseXor, All) {
@@ -260,6 +512,63 @@ TEST(LceNaiveWordwiseXor, All) {
   test_variants<alx::lce::lce_naive_wordwise_xor<int64_t>>();
   test_variants<alx::lce::lce_naive_wordwise_xor<__uint128_t>>();
   test_variants<alx::lce::lce_naive_wordwise_xor<__int128_t>>();
+  test_compare<alx::lce::lce_naive_wordwise_xor<uint8_t>>();
+}
+
+TEST(LceNaiveSimd, All) {
+  test_empty_constructor<alx::lce::lce_naive_simd<uint8_t>>();
+
+  test_simple<alx::lce::lce_naive_simd<uint8_t>>();
+  test_simple<alx::lce::lce_naive_simd<int8_t>>();
+  test_simple<alx::lce::lce_naive_simd<uint16_t>>();
+  test_simple<alx::lce::lce_naive_simd<int16_t>>();
+  test_simple<alx::lce::lce_naive_simd<uint32_t>>();
+  test_simple<alx::lce::lce_naive_simd<int32_t>>();
+  test_simple<alx::lce::lce_naive_simd<uint64_t>>();
+  test_simple<alx::lce::lce_naive_simd<int64_t>>();
+  test_simple<alx::lce::lce_naive_simd<__uint128_t>>();
+  test_simple<alx::lce::lce_naive_simd<__int128_t>>();
+
+  test_variants<alx::lce::lce_naive_simd<uint8_t>>();
+  test_variants<alx::lce::lce_naive_simd<int8_t>>();
+  test_variants<alx::lce::lce_naive_simd<uint16_t>>();
+  test_variants<alx::lce::lce_naive_simd<int16_t>>();
+  test_variants<alx::lce::lce_naive_simd<uint32_t>>();
+  test_variants<alx::lce::lce_naive_simd<int32_t>>();
+  test_variants<alx::lce::lce_naive_simd<uint64_t>>();
+  test_variants<alx::lce::lce_naive_simd<int64_t>>();
+  test_variants<alx::lce::lce_naive_simd<__uint128_t>>();
+  test_variants<alx::lce::lce_naive_simd<__int128_t>>();
+
+  // Each kernel that runs on this machine must agree with the naive scan for
+  // all alignments, lengths around the vector widths and mismatch positions.
+  using simd = alx::lce::lce_naive_simd<uint8_t>;
+  std::vector<simd::kernel_type> kernels{&simd::lce_bytes_scalar};
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse4.2")) {
+    kernels.push_back(&simd::lce_bytes_sse42);
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    kernels.push_back(&simd::lce_bytes_avx2);
+  }
+  if (__builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("bmi2")) {
+    kernels.push_back(&simd::lce_bytes_avx512);
+  }
+  std::vector<uint8_t> a(512, 'a');
+  std::vector<uint8_t> b(512 + 64, 'a');
+  for (simd::kernel_type const kernel : kernels) {
+    for (size_t offset = 0; offset < 64; offset += 7) {
+      for (size_t max_lce = 0; max_lce <= 200; ++max_lce) {
+        EXPECT_EQ(kernel(a.data(), b.data() + offset, max_lce), max_lce);
+        for (size_t mismatch = 0; mismatch < max_lce; mismatch += 13) {
+          b[offset + mismatch] = 'b';
+          EXPECT_EQ(kernel(a.data(), b.data() + offset, max_lce), mismatch);
+          b[offset + mismatch] = 'a';
+        }
+      }
+    }
+  }
+  test_compare<alx::lce::lce_naive_simd<uint8_t>>();
 }
 
 TEST(LceClassic, All) {
@@ -287,10 +596,119 @@ TEST(LceClassic, All) {
   test_variants<alx::lce::lce_classic<__uint128_t>, true, true, true, false>();
   // test_variants<alx::lce::lce_classic<__int128_t>, true, true, true,
   // false>();
+
+  test_batch<alx::lce::lce_classic<uint8_t>>();
+
+  // 40-bit and 64-bit indices, as used for texts larger than 4 GiB.
+  using gsaca_lyndon::uint40_t;
+  test_simple<alx::lce::lce_classic<uint8_t, uint40_t>>();
+  test_variants<alx::lce::lce_classic<uint8_t, uint40_t>, true, true, true,
+                false>();
+  test_batch<alx::lce::lce_classic<uint8_t, uint40_t>>();
+  test_compare<alx::lce::lce_classic<uint8_t, uint40_t>>();
+  test_simple<alx::lce::lce_classic<uint8_t, uint64_t>>();
+  test_variants<alx::lce::lce_classic<uint8_t, uint64_t>, true, true, true,
+                false>();
+  test_batch<alx::lce::lce_classic<uint8_t, uint64_t>>();
+  test_compare<alx::lce::lce_classic<uint8_t, uint64_t>>();
+
+  test_offline<alx::lce::lce_classic<uint8_t>>();
+  test_offline<alx::lce::lce_classic<uint16_t, uint64_t>>();
+  test_concurrent<alx::lce::lce_classic<uint8_t>>();
+  test_compare<alx::lce::lce_classic<uint8_t>>();
+}
+
+TEST(LceClassicLibsais, All) {
+  using libsais = alx::suffix_sort::libsais_backend;
+  test_empty_constructor<alx::lce::lce_classic<uint8_t, uint32_t, libsais>>();
+
+  test_simple<alx::lce::lce_classic<uint8_t, uint32_t, libsais>>();
+  test_simple<alx::lce::lce_classic<uint8_t, uint64_t, libsais>>();
+  test_simple<alx::lce::lce_classic<uint16_t, uint32_t, libsais>>();
+
+  test_variants<alx::lce::lce_classic<uint8_t, uint32_t, libsais>, true, true,
+                true, false>();
+  test_variants<alx::lce::lce_classic<uint32_t, uint64_t, libsais>, true, true,
+                true, false>();
+
+  test_compare<alx::lce::lce_classic<uint8_t, uint32_t, libsais>>();
+  test_compare<alx::lce::lce_classic_compressed<uint8_t, uint32_t, 8, 64,
+                                                libsais>>();
+
+  using phi = alx::suffix_sort::with_phi_lcp<alx::suffix_sort::gsaca_backend>;
+  test_simple<alx::lce::lce_classic<uint8_t, uint32_t, phi>>();
+  test_variants<alx::lce::lce_classic<uint8_t, uint32_t, phi>, true, true,
+                true, false>();
+  test_variants<alx::lce::lce_classic<uint8_t, uint64_t,
+                                      alx::suffix_sort::with_phi_lcp<libsais>>,
+                true, true, true, false>();
+}
+
+TEST(LceClassicSuccinctRmq, All) {
+  using gsaca = alx::suffix_sort::gsaca_backend;
+  using lce_ds = alx::lce::lce_classic<uint8_t, uint32_t, gsaca,
+                                       alx::rmq::rmq_succinct<uint32_t>>;
+  test_empty_constructor<lce_ds>();
+  test_simple<lce_ds>();
+  test_simple<alx::lce::lce_classic<uint16_t, uint64_t, gsaca,
+                                    alx::rmq::rmq_succinct<uint64_t>>>();
+  test_variants<lce_ds, true, true, true, false>();
+  test_batch<lce_ds>();
+  test_concurrent<lce_ds>();
+  test_compare<lce_ds>();
+}
+
+TEST(LceClassicCompressed, All) {
+  test_empty_constructor<alx::lce::lce_classic_compressed<uint8_t>>();
+
+  test_simple<alx::lce::lce_classic_compressed<uint8_t>>();
+  test_simple<alx::lce::lce_classic_compressed<uint8_t, uint32_t, 1>>();
+  test_simple<alx::lce::lce_classic_compressed<uint16_t>>();
+
+  test_variants<alx::lce::lce_classic_compressed<uint8_t>, true, true, true,
+                false>();
+  test_variants<alx::lce::lce_classic_compressed<uint16_t, uint64_t, 3>, true,
+                true, true, false>();
+
+  test_compare<alx::lce::lce_classic_compressed<uint8_t>>();
+  test_compare<alx::lce::lce_classic_compressed<uint8_t, uint32_t, 1, 8>>();
+  test_concurrent<alx::lce::lce_classic_compressed<uint8_t>>();
+
+  // Long runs create sparse regions in the PLCP bitvector.
+  auto [text, queries] = repetitive_text_and_queries<uint8_t>(20000);
+  std::fill(text.begin() + 1000, text.begin() + 9000, 'c');
+  alx::lce::lce_classic<uint8_t> classic(text);
+  alx::lce::lce_classic_compressed<uint8_t, uint32_t, 4, 16> ds(text);
+  std::vector<size_t> sa(text.size(), text.size());
+  for (size_t i = 0; i < text.size(); ++i) {
+    ASSERT_EQ(sa[ds.isa(i)], text.size()) << i;
+    sa[ds.isa(i)] = i;
+  }
+  using naive = alx::lce::lce_naive<uint8_t>;
+  for (size_t k = 1; k < sa.size(); ++k) {
+    ASSERT_TRUE(naive::is_leq_suffix(text.data(), text.size(), sa[k - 1],
+                                     sa[k]))
+        << k;
+    ASSERT_EQ(ds.lcp(k),
+              naive::lce(text.data(), text.size(), sa[k - 1], sa[k]))
+        << k;
+  }
+  for (size_t i = 0; i + 1 < text.size(); i += 7) {
+    ASSERT_EQ(ds.lce(i, i + 1), classic.lce(i, i + 1)) << i;
+    ASSERT_EQ(ds.lce(i, 5000), classic.lce(i, 5000)) << i;
+    ASSERT_EQ(ds.is_leq_suffix(i, i + 1), classic.is_leq_suffix(i, i + 1));
+  }
+  for (auto const [i, j] : queries) {
+    ASSERT_EQ(ds.lce(i, j), classic.lce(i, j)) << i << " " << j;
+  }
 }
+
 TEST(LceClassicSss, All) {
   test_empty_constructor<alx::lce::lce_classic_for_sss<uint32_t, 1024>>();
   test_simple_classic_for_sss<alx::lce::lce_classic_for_sss<uint32_t, 1024>>();
+  test_simple_classic_for_sss<alx::lce::lce_classic_for_sss<
+      uint32_t, 1024, alx::suffix_sort::gsaca_backend,
+      alx::rmq::rmq_succinct<uint32_t>>>();
 }
 
 TEST(LceSssNaive, All) {
@@ -317,6 +735,10 @@ TEST(LceSssNaive, All) {
   // test_variants<alx::lce::lce_sss_naive<int64_t, 16>>();
   // test_variants<alx::lce::lce_sss_naive<__uint128_t, 16>>();
   // test_variants<alx::lce::lce_sss_naive<__int128_t, 16>>();
+
+  test_batch<alx::lce::lce_sss_naive<uint8_t, 16, uint32_t, false>>();
+  test_concurrent<alx::lce::lce_sss_naive<uint8_t, 16, uint32_t, false>>();
+  test_compare<alx::lce::lce_sss_naive<uint8_t, 16, uint32_t, false>>();
 }
 TEST(LceSssNaivePL, All) {
   test_empty_constructor<alx::lce::lce_sss_naive<uint8_t, 16>>();
@@ -342,6 +764,17 @@ TEST(LceSssNaivePL, All) {
   // test_variants<alx::lce::lce_sss_naive<int64_t, 16>>();
   // test_variants<alx::lce::lce_sss_naive<__uint128_t, 16>>();
   // test_variants<alx::lce::lce_sss_naive<__int128_t, 16>>();
+
+  test_batch<alx::lce::lce_sss_naive<uint8_t, 16, uint32_t, true>>();
+  test_concurrent<alx::lce::lce_sss_naive<uint8_t, 16, uint32_t, true>>();
+}
+
+TEST(LceSssNaiveCompact, All) {
+  test_simple<alx::lce::lce_sss_naive<uint8_t, 16, uint32_t, false, true>>();
+  test_variants<alx::lce::lce_sss_naive<uint8_t, 16, uint32_t, false, true>>();
+  test_variants<alx::lce::lce_sss_naive<uint8_t, 16, uint32_t, true, true>>();
+  test_batch<alx::lce::lce_sss_naive<uint8_t, 16, uint32_t, false, true>>();
+  test_compare<alx::lce::lce_sss_naive<uint8_t, 16, uint32_t, false, true>>();
 }
 
 TEST(LceSssNoSs, All) {
@@ -370,6 +803,10 @@ TEST(LceSssNoSs, All) {
   // test_variants<alx::lce::lce_sss_noss<int64_t, 16>>();
   // test_variants<alx::lce::lce_sss_noss<__uint128_t, 16>>();
   // test_variants<alx::lce::lce_sss_noss<__int128_t, 16>>();
+
+  test_batch<alx::lce::lce_sss_noss<uint8_t, 16, uint32_t, false>>();
+  test_concurrent<alx::lce::lce_sss_noss<uint8_t, 16, uint32_t, false>>();
+  test_compare<alx::lce::lce_sss_noss<uint8_t, 16, uint32_t, false>>();
 }
 TEST(LceSssNoSsPL, All) {
   test_empty_constructor<alx::lce::lce_sss_noss<uint8_t, 16>>();
@@ -397,6 +834,19 @@ TEST(LceSssNoSsPL, All) {
   // test_variants<alx::lce::lce_sss_noss<int64_t, 16>>();
   // test_variants<alx::lce::lce_sss_noss<__uint128_t, 16>>();
   // test_variants<alx::lce::lce_sss_noss<__int128_t, 16>>();
+
+  test_batch<alx::lce::lce_sss_noss<uint8_t, 16, uint32_t, true>>();
+  test_concurrent<alx::lce::lce_sss_noss<uint8_t, 16, uint32_t, true>>();
+}
+
+TEST(LceSssNoSsCompact, All) {
+  test_simple<alx::lce::lce_sss_noss<uint8_t, 16, uint32_t, false, true>>();
+  test_variants<alx::lce::lce_sss_noss<uint8_t, 16, uint32_t, false, true>,
+                true, true, true, false>();
+  test_variants<alx::lce::lce_sss_noss<uint8_t, 16, uint32_t, true, true>,
+                true, true, true, false>();
+  test_batch<alx::lce::lce_sss_noss<uint8_t, 16, uint32_t, false, true>>();
+  test_compare<alx::lce::lce_sss_noss<uint8_t, 16, uint32_t, false, true>>();
 }
 
 TEST(LceSss, All) {
@@ -425,6 +875,25 @@ TEST(LceSss, All) {
   // test_variants<alx::lce::lce_sss<int64_t, 16>>();
   // test_variants<alx::lce::lce_sss<__uint128_t, 16>>();
   // test_variants<alx::lce::lce_sss<__int128_t, 16>>();
+
+  test_batch<alx::lce::lce_sss<uint8_t, 16, uint32_t, false>>();
+  test_concurrent<alx::lce::lce_sss<uint8_t, 16, uint32_t, false>>();
+  test_many<alx::lce::lce_sss<uint8_t, 16, uint32_t, false>>();
+  test_compare<alx::lce::lce_sss<uint8_t, 16, uint32_t, false>>();
+}
+
+TEST(LceSssLibsais, All) {
+  using libsais = alx::suffix_sort::libsais_backend;
+  test_simple<alx::lce::lce_sss<uint8_t, 16, uint32_t, false, libsais>>();
+  test_variants<alx::lce::lce_sss<uint8_t, 16, uint32_t, false, libsais>, true,
+                true, true, false>();
+  test_compare<alx::lce::lce_sss<uint8_t, 16, uint32_t, false, libsais>>();
+
+  using phi = alx::suffix_sort::with_phi_lcp<libsais>;
+  test_simple<alx::lce::lce_sss<uint8_t, 16, uint32_t, false, phi>>();
+  test_variants<alx::lce::lce_sss<uint8_t, 16, uint32_t, true, phi>, true,
+                true, true, false>();
+  test_batch<alx::lce::lce_sss<uint8_t, 16, uint32_t, false, phi>>();
 }
 
 TEST(LceSssPL, All) {
@@ -453,11 +922,17 @@ TEST(LceSssPL, All) {
   // test_variants<alx::lce::lce_sss<int64_t, 16>>();
   // test_variants<alx::lce::lce_sss<__uint128_t, 16>>();
   // test_variants<alx::lce::lce_sss<__int128_t, 16>>();
+
+  test_batch<alx::lce::lce_sss<uint8_t, 16, uint32_t, true>>();
+  test_concurrent<alx::lce::lce_sss<uint8_t, 16, uint32_t, true>>();
+  test_many<alx::lce::lce_sss<uint8_t, 16, uint32_t, true>>();
+  test_compare<alx::lce::lce_sss<uint8_t, 16, uint32_t, true>>();
 }
 
 TEST(LceMemcmp, SS) {
   test_empty_constructor<alx::lce::lce_memcmp>();
   test_suffix_sorting<alx::lce::lce_memcmp>();
+  test_compare<alx::lce::lce_memcmp>();
 }
 
 TEST(LceFP, All) {
@@ -477,6 +952,19 @@ TEST(LceFP, All) {
 
   test_variants<alx::lce::lce_fp<uint8_t>>();
   test_variants<alx::lce::lce_fp<int8_t>>();
+
+  test_fp_extreme_blocks<alx::lce::lce_fp<uint8_t>>();
+  test_fp_extreme_blocks<alx::lce::lce_fp<uint8_t, 32, false>>();
+  test_retransform_parallel<alx::lce::lce_fp<uint8_t>>();
+  test_read_only<alx::lce::lce_fp<uint8_t, 32, false>>();
+  test_batch<alx::lce::lce_fp<uint8_t, 32, false>>();
+  test_batch<alx::lce::lce_fp<uint8_t>>();
+  test_concurrent<alx::lce::lce_fp<uint8_t>>();
+  test_many<alx::lce::lce_fp<uint8_t>>();
+  test_many<alx::lce::lce_fp<uint8_t, 8>>();
+  test_compare<alx::lce::lce_fp<uint8_t>>();
+  test_compare<alx::lce::lce_fp<int8_t>>();
+  test_compare<alx::lce::lce_fp<uint8_t, 8, false>>();
   // test_variants<alx::lce::lce_fp<uint16_t>>();
   // test_variants<alx::lce::lce_fp<int16_t>>();
   // test_variants<alx::lce::lce_fp<uint32_t>>();
@@ -487,10 +975,61 @@ TEST(LceFP, All) {
   // test_variants<alx::lce::lce_fp<__int128_t>>();
 }
 
+TEST(LceFPMersenne, All) {
+  test_empty_constructor<alx::lce::lce_fp_mersenne<unsigned char>>();
+  test_retransform<alx::lce::lce_fp_mersenne<unsigned char>>();
+
+  test_simple<alx::lce::lce_fp_mersenne<uint8_t>>();
+  test_simple<alx::lce::lce_fp_mersenne<int8_t>>();
+
+  test_variants<alx::lce::lce_fp_mersenne<uint8_t>>();
+  test_variants<alx::lce::lce_fp_mersenne<int8_t>>();
+
+  test_fp_extreme_blocks<alx::lce::lce_fp_mersenne<uint8_t>>();
+  test_retransform_parallel<alx::lce::lce_fp_mersenne<uint8_t>>();
+  test_read_only<alx::lce::lce_fp_mersenne<uint8_t>>();
+  test_batch<alx::lce::lce_fp_mersenne<uint8_t>>();
+  test_concurrent<alx::lce::lce_fp_mersenne<uint8_t>>();
+  test_compare<alx::lce::lce_fp_mersenne<uint8_t>>();
+  test_compare<alx::lce::lce_fp_mersenne<int8_t, 8>>();
+  test_fp_base_order<alx::lce::lce_fp_mersenne<uint8_t>>();
+}
+
+TEST(LceFPSampled, All) {
+  test_empty_constructor<alx::lce::lce_fp_sampled<unsigned char>>();
+
+  test_simple<alx::lce::lce_fp_sampled<uint8_t>>();
+  test_simple<alx::lce::lce_fp_sampled<int8_t>>();
+
+  test_variants<alx::lce::lce_fp_sampled<uint8_t>>();
+  test_variants<alx::lce::lce_fp_sampled<int8_t>>();
+
+  test_fp_extreme_blocks<alx::lce::lce_fp_sampled<uint8_t>>();
+  test_fp_extreme_blocks<alx::lce::lce_fp_sampled<uint8_t, 8, 1>>();
+  test_fp_extreme_blocks<alx::lce::lce_fp_sampled<uint8_t, 64, 5>>();
+  test_read_only<alx::lce::lce_fp_sampled<uint8_t>>();
+  test_read_only<alx::lce::lce_fp_sampled<uint8_t, 16, 64>>();
+  test_batch<alx::lce::lce_fp_sampled<uint8_t>>();
+  test_concurrent<alx::lce::lce_fp_sampled<uint8_t>>();
+  test_compare<alx::lce::lce_fp_sampled<uint8_t>>();
+  test_fp_base_order<alx::lce::lce_fp_sampled<uint8_t>>();
+  test_fp_base_order<alx::lce::lce_fp_sampled<uint8_t, 8, 1>>();
+
+  // The text does not need to consist of full blocks.
+  auto [text, queries] = repetitive_text_and_queries<uint8_t>(8005);
+  alx::lce::lce_fp_sampled<uint8_t, 32, 3> ds(text);
+  for (auto const [i, j] : queries) {
+    ASSERT_EQ(ds.lce(i, j), alx::lce::lce_naive<uint8_t>::lce(
+                                text.data(), text.size(), i, j))
+        << i << " " << j;
+  }
+}
+
 TEST(LceRkPrezza, All) {
   test_empty_constructor<rklce::lce_rk_prezza>();
   // test_retransform<rklce::lce_rk_prezza>();
 
   test_simple<rklce::lce_rk_prezza>();
   // test_variants<rklce::lce_rk_prezza>();
+  test_compare<rklce::lce_rk_prezza>();
 }
\ No newline at end of file
@@ -7,13 +7,19 @@
  ******************************************************************************/
 
 #include <gtest/gtest.h>
+#include <sys/mman.h>
 
 #include <limits>
 #include <numeric>
+#include <type_traits>
+#include <vector>
 
+#include "rmq/rmq_bit.hpp"
 #include "rmq/rmq_n.hpp"
 #include "rmq/rmq_naive.hpp"
 #include "rmq/rmq_nlgn.hpp"
+#include "rmq/rmq_offline.hpp"
+#include "rmq/rmq_succinct.hpp"
 
 template <typename rmq_ds_type>
 void test_empty_constructor() {
@@ -62,6 +68,46 @@ void test_simple() {
   }
 }
 
+// Compare all short ranges with rmq_naive on data with many equal keys, so
+// that the leftmost minimum must be returned.
+template <typename rmq_ds_type>
+void test_short_ranges() {
+  using key_type = rmq_ds_type::key_type;
+  for (size_t size : {1, 63, 64, 65, 200, 1000}) {
+    std::vector<key_type> data(size);
+    std::generate(data.begin(), data.end(), [] { return std::rand() % 8; });
+    rmq_ds_type rmq(data);
+    alx::rmq::rmq_naive<key_type> naive(data);
+    for (size_t i = 0; i < size; ++i) {
+      for (size_t j = i; j < std::min(size, i + 200); ++j) {
+        ASSERT_EQ(rmq.rmq(i, j), naive.rmq(i, j)) << i << " " << j;
+        if (i != j) {
+          ASSERT_EQ(rmq.rmq_shifted(j, i), naive.rmq_shifted(j, i));
+        }
+      }
+    }
+  }
+}
+
+// Compare ranges of all lengths in a larger array with a running minimum.
+template <typename rmq_ds_type>
+void test_long_ranges() {
+  using key_type = rmq_ds_type::key_type;
+  std::vector<key_type> data(300'000);
+  std::generate(data.begin(), data.end(), [] { return std::rand() % 1000; });
+  rmq_ds_type rmq(data);
+  for (size_t k = 0; k < 20; ++k) {
+    size_t const left = std::rand() % 1000;
+    size_t check = left;
+    for (size_t right = left + 1; right < data.size(); ++right) {
+      if (data[check] > data[right]) {
+        check = right;
+      }
+      ASSERT_EQ(rmq.rmq(left, right), check) << left << " " << right;
+    }
+  }
+}
+
 TEST(RmqNaive, All) {
   test_empty_constructor<alx::rmq::rmq_naive<uint64_t>>();
   test_simple<alx::rmq::rmq_naive<unsigned char>>();
@@ -82,6 +128,37 @@ TEST(RmqNlgn, All) {
   test_simple<alx::rmq::rmq_nlgn<uint64_t>>();
   test_simple<alx::rmq::rmq_nlgn<int64_t>>();
   test_simple<alx::rmq::rmq_nlgn<__uint128_t>>();
+  test_long_ranges<alx::rmq::rmq_nlgn<uint32_t>>();
+  test_long_ranges<alx::rmq::rmq_nlgn<uint64_t, uint64_t>>();
+}
+
+// The levels above 2^32 need more than 4 GiB of data, so their entries are
+// written and read directly.
+TEST(RmqNlgn, WideLevels) {
+  using rmq_type = alx::rmq::rmq_nlgn<uint64_t, uint64_t>;
+  EXPECT_EQ(rmq_type::offset_width(8), 1);
+  EXPECT_EQ(rmq_type::offset_width(9), 2);
+  EXPECT_EQ(rmq_type::offset_width(16), 2);
+  EXPECT_EQ(rmq_type::offset_width(17), 4);
+  EXPECT_EQ(rmq_type::offset_width(32), 4);
+  EXPECT_EQ(rmq_type::offset_width(33), 8);
+  EXPECT_EQ(rmq_type::offset_width(63), 8);
+
+  for (size_t l : {8, 16, 32, 33, 40, 63}) {
+    std::vector<uint64_t> entries(4);
+    uint8_t* const level = reinterpret_cast<uint8_t*>(entries.data());
+    size_t const max_offset = (size_t{1} << l) - 1;
+    rmq_type::with_level(level, l, [&](auto* typed_level) {
+      using offset_type = std::remove_pointer_t<decltype(typed_level)>;
+      EXPECT_EQ(sizeof(offset_type), rmq_type::offset_width(l));
+      typed_level[1] = static_cast<offset_type>(max_offset);
+      typed_level[2] = static_cast<offset_type>(max_offset / 2 + 1);
+    });
+    EXPECT_EQ(rmq_type::level_min(level, l, 0), 0);
+    EXPECT_EQ(rmq_type::level_min(level, l, 1), 1 + max_offset);
+    EXPECT_EQ(rmq_type::level_min(level, l, 2), 2 + max_offset / 2 + 1);
+    EXPECT_EQ(rmq_type::level_min(level, l, 3), 3);
+  }
 }
 
 TEST(RmqN, All) {
@@ -93,4 +170,97 @@ TEST(RmqN, All) {
   test_simple<alx::rmq::rmq_n<uint64_t>>();
   test_simple<alx::rmq::rmq_n<int64_t>>();
   test_simple<alx::rmq::rmq_n<__uint128_t>>();
+  test_short_ranges<alx::rmq::rmq_n<uint32_t>>();
+  test_long_ranges<alx::rmq::rmq_n<uint32_t>>();
+}
+
+TEST(RmqBit, All) {
+  test_empty_constructor<alx::rmq::rmq_bit<uint64_t>>();
+  test_simple<alx::rmq::rmq_bit<unsigned char>>();
+  test_simple<alx::rmq::rmq_bit<uint8_t>>();
+  test_simple<alx::rmq::rmq_bit<uint32_t>>();
+  test_simple<alx::rmq::rmq_bit<int32_t>>();
+  test_simple<alx::rmq::rmq_bit<uint64_t>>();
+  test_simple<alx::rmq::rmq_bit<int64_t>>();
+  test_simple<alx::rmq::rmq_bit<__uint128_t>>();
+  test_short_ranges<alx::rmq::rmq_bit<uint32_t>>();
+  test_short_ranges<alx::rmq::rmq_bit<int8_t>>();
+  test_long_ranges<alx::rmq::rmq_bit<uint32_t>>();
+}
+
+TEST(RmqSuccinct, All) {
+  test_empty_constructor<alx::rmq::rmq_succinct<uint64_t>>();
+  test_simple<alx::rmq::rmq_succinct<unsigned char>>();
+  test_simple<alx::rmq::rmq_succinct<uint8_t>>();
+  test_simple<alx::rmq::rmq_succinct<uint32_t>>();
+  test_simple<alx::rmq::rmq_succinct<int32_t>>();
+  test_simple<alx::rmq::rmq_succinct<uint64_t>>();
+  test_simple<alx::rmq::rmq_succinct<int64_t>>();
+  test_simple<alx::rmq::rmq_succinct<__uint128_t>>();
+  test_short_ranges<alx::rmq::rmq_succinct<uint32_t>>();
+  test_short_ranges<alx::rmq::rmq_succinct<int8_t>>();
+  test_long_ranges<alx::rmq::rmq_succinct<uint32_t>>();
+  test_long_ranges<alx::rmq::rmq_succinct<uint64_t, uint64_t>>();
+
+  // Sorted data is the worst case for the stack, the space does not depend on
+  // the data.
+  std::vector<uint32_t> data(1'000'000);
+  std::iota(data.begin(), data.end(), 0);
+  alx::rmq::rmq_succinct<uint32_t> rmq(data);
+  EXPECT_LT(rmq.bits_per_element(), 3.0);
+  EXPECT_EQ(rmq.rmq(17, 999'999), 17);
+}
+
+TEST(RmqOffline, All) {
+  for (size_t size : {1, 64, 1000, 100'000}) {
+    std::vector<int32_t> data(size);
+    std::generate(data.begin(), data.end(), [] { return std::rand() % 100; });
+    alx::rmq::rmq_naive<int32_t> naive(data);
+
+    std::vector<std::pair<uint32_t, uint32_t>> ranges(10'000);
+    for (auto& range : ranges) {
+      uint32_t const i = std::rand() % size;
+      uint32_t const j = std::rand() % std::min<size_t>(size, i + 300);
+      range = {std::min(i, j), std::max(i, j)};
+    }
+    std::vector<size_t> result = alx::rmq::rmq_offline(
+        data.data(), data.size(),
+        std::span<std::pair<uint32_t, uint32_t> const>(ranges));
+    for (size_t k = 0; k < ranges.size(); ++k) {
+      ASSERT_EQ(result[k], naive.rmq(ranges[k].first, ranges[k].second))
+          << ranges[k].first << " " << ranges[k].second;
+    }
+  }
+}
+
+// More than 2^32 elements. The array is an anonymous mapping, so only the
+// pages that are written are backed by memory, all others read as zero. The
+// construction still scans 4 GiB, so the test only runs when requested with
+// --gtest_also_run_disabled_tests.
+TEST(RmqN, DISABLED_LargeInput) {
+  size_t const base = size_t{1} << 32;
+  size_t const size = base + (size_t{1} << 20);
+  void* const memory =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE,
+           MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  ASSERT_NE(memory, MAP_FAILED);
+  madvise(memory, size, MADV_HUGEPAGE);
+  int8_t* const data = static_cast<int8_t*>(memory);
+  data[17] = -3;
+  data[base + 5] = -1;
+  data[base + 100'000] = -2;
+
+  {
+    alx::rmq::rmq_n<int8_t, uint64_t, 4096> rmq(data, size);
+    EXPECT_EQ(rmq.rmq(0, size - 1), 17);
+    EXPECT_EQ(rmq.rmq(18, size - 1), base + 100'000);
+    EXPECT_EQ(rmq.rmq(18, base + 99'999), base + 5);
+    EXPECT_EQ(rmq.rmq(base + 6, base + 99'999), base + 6);
+    EXPECT_EQ(rmq.rmq(base - 10, base + 10), base + 5);
+    EXPECT_EQ(rmq.rmq(base + 100'001, size - 1), base + 100'001);
+    EXPECT_EQ(rmq.rmq_shifted(17, size - 1), base + 100'000);
+    EXPECT_EQ(rmq.rmq_shifted(base + 5, base - 10), base + 5);
+    EXPECT_EQ(rmq.rmq_shifted(base + 4, base - 10), base - 9);
+  }
+  munmap(memory, size);
 }
@@ -146,6 +146,34 @@ TEST(ModularArithmetic, Mod128) {
   }
 }
 
+TEST(ModularArithmetic, SubAndPow2Mod64) {
+  constexpr uint64_t mod61 = (uint64_t{1} << 61) - 1;
+
+  std::array<uint64_t, 5> nums{0, 1, mod61 / 2, mod61 / 2 + 1, mod61 - 1};
+
+  for (auto a : nums) {
+    for (auto b : nums) {
+      uint64_t res0 = static_cast<uint64_t>(
+          (uint128_t{a} + mod61 - b) % mod61);
+      uint64_t res1 = alx::mersenne::sub_mod<uint64_t, mod61>(a, b);
+      EXPECT_EQ(res1, res0);
+    }
+    for (auto b : nums) {
+      uint64_t res0 = static_cast<uint64_t>((uint128_t{a} * b) % mod61);
+      uint64_t res1 = alx::mersenne::mult_mod<uint64_t, mod61>(a, b);
+      EXPECT_EQ(res1, res0);
+    }
+    for (uint64_t exp : {0, 1, 2, 8, 61, 1000}) {
+      uint128_t res0 = 1;
+      for (size_t i = 0; i < exp; ++i) {
+        res0 = (res0 * a) % mod61;
+      }
+      uint64_t res1 = alx::mersenne::pow_mod<uint64_t, mod61>(a, exp);
+      EXPECT_EQ(res1, res0);
+    }
+  }
+}
+
 TEST(RollingHash, Roll) {
   std::string text =
       "Lorem ipsum dolor sit amet, consetetur sadipscing elitr, sed diam "
@@ -172,4 +200,34 @@ TEST(RollingHash, Roll) {
     rolling_hasher_end.roll_in(text[i]);
   }
   EXPECT_EQ(rolling_hasher.get_fp(), rolling_hasher_end.get_fp());
-}
\ No newline at end of file
+}
+
+TEST(RollingHash, RollCompact) {
+  std::string text =
+      "Lorem ipsum dolor sit amet, consetetur sadipscing elitr, sed diam "
+      "nonumy eirmod tempor invidunt ut labore et dolore magna aliquyam erat, "
+      "sed diam voluptua. At vero eos et accusam et justo duo dolores et ea "
+      "rebum. Stet clita kasd gubergren, no sea takimata sanctus est Lorem "
+      "ipsum dolor sit amet. \xff\xfe\x01\x80 Lorem ipsum dolor sit amet.";
+  size_t tau = 16;
+  alx::rolling_hash::rk_compact rolling_hasher(tau, 123123);
+  alx::rolling_hash::rk_prime<61> rolling_hasher_61(tau, 123123);
+  // roll
+  for (size_t i = 0; i < tau; ++i) {
+    rolling_hasher.roll_in(text[i]);
+    rolling_hasher_61.roll_in(text[i]);
+  }
+  for (size_t i = tau; i < text.size(); ++i) {
+    rolling_hasher.roll(text[i - tau], text[i]);
+    rolling_hasher_61.roll(text[i - tau], text[i]);
+    // Same fingerprints as with the large table
+    EXPECT_EQ(rolling_hasher.get_fp(), rolling_hasher_61.get_fp());
+  }
+  // check fp
+  alx::rolling_hash::rk_compact rolling_hasher_end(tau, 123123);
+  for (size_t i = text.size() - tau; i < text.size(); ++i) {
+    rolling_hasher_end.roll_in(text[i]);
+  }
+  EXPECT_EQ(rolling_hasher.get_fp(), rolling_hasher_end.get_fp());
+  EXPECT_LT(rolling_hasher.get_fp(), rolling_hasher.get_prime());
+}
@@ -0,0 +1,84 @@
+/*******************************************************************************
+ * test/rolling_hash/test_sliding_window_min.cpp
+ *
+ * Copyright (C) 2026 Alexander Herlez <alexander.herlez@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "rolling_hash/sliding_window_min.hpp"
+
+size_t naive_min_pos(std::vector<uint64_t> const& values, size_t begin,
+                     size_t width) {
+  size_t min = begin;
+  for (size_t i = begin; i < begin + width; ++i) {
+    if (values[i] < values[min]) {
+      min = i;
+    }
+  }
+  return min;
+}
+
+void test_window(std::vector<uint64_t> const& values, size_t width) {
+  alx::rolling_hash::sliding_window_min<uint64_t> window(width);
+  auto const value = [&values](size_t pos) { return values[pos]; };
+  std::mt19937_64 gen(width);
+  // Mostly single steps, some jumps and some steps back. Both queries are
+  // mixed on the same window.
+  size_t begin = 0;
+  while (begin + width <= values.size()) {
+    bool const next = gen() % 2;
+    size_t const min_pos = next ? window.next_min_pos(begin, value)
+                                : window.min_pos(begin, value);
+    EXPECT_EQ(min_pos, naive_min_pos(values, begin, width))
+        << "begin=" << begin << " width=" << width << " next=" << next;
+    size_t const r = gen() % 64;
+    if (r == 0) {
+      begin -= std::min<size_t>(begin, gen() % (2 * width));
+    } else if (r == 1) {
+      begin += gen() % (3 * width);
+    } else {
+      ++begin;
+    }
+  }
+}
+
+TEST(SlidingWindowMin, Random) {
+  std::mt19937_64 gen(1337);
+  std::vector<uint64_t> values(10'000);
+  for (auto& value : values) {
+    value = gen();
+  }
+  for (size_t width : {1, 2, 3, 17, 64, 257}) {
+    test_window(values, width);
+  }
+}
+
+TEST(SlidingWindowMin, Ties) {
+  std::mt19937_64 gen(1337);
+  std::vector<uint64_t> values(10'000);
+  for (auto& value : values) {
+    value = gen() % 4;
+  }
+  for (size_t width : {1, 2, 3, 17, 64, 257}) {
+    test_window(values, width);
+  }
+}
+
+TEST(SlidingWindowMin, Monotone) {
+  std::vector<uint64_t> increasing(5'000);
+  std::vector<uint64_t> periodic(5'000);
+  for (size_t i = 0; i < increasing.size(); ++i) {
+    increasing[i] = i;
+    periodic[i] = (i * 7) % 13;
+  }
+  for (size_t width : {1, 5, 100}) {
+    test_window(increasing, width);
+    test_window(periodic, width);
+  }
+}
@@ -11,17 +11,28 @@
 #include <gtest/gtest.h>
 #include <libsais.h>
 
+#include <fcntl.h>
+#include <omp.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+#include <type_traits>
 #include <unordered_set>
 
 #include "pred/pred_index.hpp"
+#include "rolling_hash/sss_stream.hpp"
 #include "rolling_hash/string_synchronizing_set.hpp"
+#include "test_texts.hpp"
 
 __extension__ typedef unsigned __int128 uint128_t;
 
 template <typename text_t, typename sss_t>
 bool check_string_synchronizing_set(text_t const& text, sss_t const& sss_ds) {
   std::vector<typename sss_t::index_type> const& sss = sss_ds.get_sss();
-  std::vector<uint128_t> const& fps = sss_ds.get_fps();
+  auto const& fps = sss_ds.get_fps();
 
   alx::pred::pred_index<typename sss_t::index_type, 7,
                         typename sss_t::index_type>
@@ -95,11 +106,22 @@ bool check_string_synchronizing_set(text_t const& text, sss_t const& sss_ds) {
           fmt::print("{} should equal {}\n", sss[pos_in_sss_j], sa[i]);
           return false;
         }
-        if (sss_ds.fps_calculated() &&
-            (fps[pos_in_sss_i] << 21 != fps[pos_in_sss_j] << 21)) {
-          fmt::print(" fingerprints should be equal: {} != {}\n",
-                     fps[pos_in_sss_i], fps[pos_in_sss_j]);
-          return false;
+        // The fingerprints may only differ in the run distances.
+        if (sss_ds.fps_calculated()) {
+          bool fps_equal;
+          if constexpr (std::is_same_v<typename sss_t::stored_fp_type,
+                                       uint128_t>) {
+            fps_equal = fps[pos_in_sss_i] << 21 == fps[pos_in_sss_j] << 21;
+          } else {
+            fps_equal = sss_ds.get_run_distance(pos_in_sss_i) !=
+                            sss_ds.get_run_distance(pos_in_sss_j) ||
+                        fps[pos_in_sss_i] == fps[pos_in_sss_j];
+          }
+          if (!fps_equal) {
+            fmt::print(" fingerprints should be equal: {} != {}\n",
+                       fps[pos_in_sss_i], fps[pos_in_sss_j]);
+            return false;
+          }
         }
       }
     }
@@ -119,6 +141,12 @@ bool check_string_synchronizing_set(text_t const& text, sss_t const& sss_ds) {
       }
     }
   }
+  for (size_t i = 0; i < sss.size(); i++) {
+    if (sss_ds.get_run_info_at(i) != sss_ds.get_run_info(sss[i])) {
+      std::cout << "\nsss[" << i << "] has inconsistent run information.";
+      return false;
+    }
+  }
 
   // Now assert that run information is rising.
   int64_t last_run_pos;
@@ -186,6 +214,271 @@ bool check_string_synchronizing_set(text_t const& text, sss_t const& sss_ds) {
   return true;
 }
 
+// The compact fingerprints must be equal iff the 128-bit fingerprints are.
+template <typename sss_t, typename compact_sss_t>
+void expect_equal_compact_fps(sss_t const& sss_ds,
+                              compact_sss_t const& compact_sss_ds) {
+  EXPECT_EQ(sss_ds.get_sss(), compact_sss_ds.get_sss());
+  auto const& fps = sss_ds.get_fps();
+  auto const& compact_fps = compact_sss_ds.get_fps();
+  ASSERT_EQ(fps.size(), compact_fps.size());
+  constexpr uint128_t prime = (uint128_t{1} << 61) - 1;
+  std::vector<size_t> run_positions;
+  for (size_t i = 0; i < fps.size(); ++i) {
+    EXPECT_EQ(sss_ds.get_run_distance(i), compact_sss_ds.get_run_distance(i));
+    if (compact_sss_ds.get_run_distance(i) == 0) {
+      EXPECT_EQ(compact_fps[i], fps[i] % prime);
+    } else {
+      run_positions.push_back(i);
+    }
+  }
+  for (size_t i : run_positions) {
+    for (size_t j : run_positions) {
+      EXPECT_EQ(fps[i] == fps[j], compact_fps[i] == compact_fps[j]);
+    }
+  }
+}
+
+template <uint64_t tau, typename text_t>
+void test_compact_fps(text_t const& text) {
+  alx::rolling_hash::sss<uint32_t, tau> sss(text, true);
+  alx::rolling_hash::sss<uint32_t, tau, alx::rolling_hash::rk_prime<>, true>
+      compact_sss(text, true);
+  EXPECT_TRUE(check_string_synchronizing_set(text, compact_sss));
+  expect_equal_compact_fps(sss, compact_sss);
+}
+
+// The streaming construction must give the same positions and fingerprints
+// as the construction in memory, for any chunk size.
+template <uint64_t tau, typename text_t>
+void test_sss_stream(text_t const& text) {
+  std::filesystem::path const text_path =
+      std::filesystem::temp_directory_path() / "alx_test_sss_stream";
+  {
+    std::ofstream out(text_path, std::ios::binary);
+    out.write(text.data(), text.size());
+  }
+  // The streaming construction reads zeros behind the text.
+  std::vector<uint8_t> padded_text(text.begin(), text.end());
+  padded_text.resize(text.size() + 3 * tau + 1);
+  alx::rolling_hash::sss<uint32_t, tau> sss(padded_text.data(), text.size(),
+                                            true);
+
+  int const fd = open(text_path.c_str(), O_RDONLY);
+  ASSERT_GE(fd, 0);
+  for (size_t chunk_size : {tau, 5 * tau + 1, text.size()}) {
+    alx::rolling_hash::sss_stream<uint32_t, tau> stream(fd, text.size(),
+                                                        chunk_size);
+    alx::rolling_hash::sss_vector_sink<uint32_t> sink;
+    EXPECT_TRUE(stream.build(sink, true));
+    EXPECT_EQ(stream.has_runs(), sss.has_runs());
+    EXPECT_EQ(sink.sss, sss.get_sss());
+    EXPECT_TRUE(sink.fps == sss.get_fps());
+  }
+  close(fd);
+  std::filesystem::remove(text_path);
+}
+
+// Reference construction of the sss as it was done with two passes: All slices
+// are filled without detecting runs, and if there are too many positions, all
+// of them are filled again without the positions in q. The minima are found by
+// scanning the ranges, and the fingerprints of all windows are computed
+// up front. The text must be followed by 4 * tau readable characters.
+template <uint64_t tau, typename rolling_hash_t>
+class reference_sss {
+ public:
+  typedef typename rolling_hash_t::fp_type fp_type;
+
+  std::vector<uint32_t> sss;
+  std::vector<uint128_t> fps;
+  std::map<size_t, int64_t> run_info;
+  bool has_runs;
+
+  reference_sss(uint8_t const* text, size_t size, size_t num_slices)
+      : m_text(text),
+        m_size(size),
+        m_fps(window_fps(tau)),
+        m_fps3(window_fps(3 * tau)),
+        m_small_fps(window_fps(tau / 4)) {
+    size_t const sss_end = size - 2 * tau + 1;
+    size_t const slice_size = sss_end / num_slices;
+    auto const slice = [&](size_t const t) {
+      size_t const to =
+          (t < num_slices - 1) ? (t + 1) * slice_size : sss_end;
+      return std::make_pair(t * slice_size, to);
+    };
+
+    for (size_t t = 0; t < num_slices; ++t) {
+      auto const [from, to] = slice(t);
+      fill_synchronizing_set(from, to);
+    }
+    has_runs = sss.size() > size * 4 / tau;
+    if (has_runs) {
+      sss.clear();
+      for (size_t t = 0; t < num_slices; ++t) {
+        auto const [from, to] = slice(t);
+        fill_synchronizing_set_runs(from, to, calculate_q(from, to));
+      }
+    }
+
+    for (size_t k = 0; k < sss.size(); ++k) {
+      fps.push_back(m_fps3[sss[k]]);
+      // add distance to positions that start periodic area
+      if (has_runs && k + 1 < sss.size() && sss[k + 1] - sss[k] > tau) {
+        fps[k] += uint128_t{sss[k + 1] - sss[k]} << 107;
+      }
+    }
+    if (has_runs) {
+      sss.push_back(sss_end);  // sentinel needed for text with runs
+      fps.push_back(1);
+    }
+  }
+
+ private:
+  // Return the fingerprints of text[j..j + window) for all j < size.
+  std::vector<fp_type> window_fps(size_t const window) const {
+    rolling_hash_t rk(window, 296819);
+    for (size_t j = 0; j < window; ++j) {
+      rk.roll_in(m_text[j]);
+    }
+    std::vector<fp_type> result{rk.get_fp()};
+    for (size_t j = 1; j < m_size; ++j) {
+      result.push_back(rk.roll(m_text[j - 1], m_text[j + window - 1]));
+    }
+    return result;
+  }
+
+  void fill_synchronizing_set(size_t const from, size_t const to) {
+    for (size_t i = from; i < to; ++i) {
+      size_t first_min = i;
+      for (size_t j = i; j <= i + tau; ++j) {
+        if (m_fps[j] < m_fps[first_min]) {
+          first_min = j;
+        }
+      }
+      if (m_fps[first_min] == m_fps[i] || m_fps[first_min] == m_fps[i + tau]) {
+        sss.push_back(i);
+      }
+    }
+  }
+
+  void fill_synchronizing_set_runs(
+      size_t const from, size_t const to,
+      std::vector<std::pair<size_t, size_t>> qset) {
+    qset.emplace_back(std::numeric_limits<size_t>::max(),
+                      std::numeric_limits<size_t>::max());
+    auto it_q = qset.begin();
+    for (size_t i = from; i < to; ++i) {
+      while (it_q->second < i) {
+        ++it_q;
+      }
+      // Find the first minimum of the fingerprints not in q.
+      size_t first_min = std::numeric_limits<size_t>::max();
+      auto it_qt = it_q;
+      for (size_t j = i; j <= i + tau; ++j) {
+        while (it_qt->second < j) {
+          ++it_qt;
+        }
+        if (it_qt->first <= j) {
+          continue;
+        }
+        if (first_min == std::numeric_limits<size_t>::max() ||
+            m_fps[j] < m_fps[first_min]) {
+          first_min = j;
+        }
+      }
+      if (first_min == std::numeric_limits<size_t>::max()) {
+        continue;
+      }
+      if (m_fps[first_min] == m_fps[i] || m_fps[first_min] == m_fps[i + tau]) {
+        sss.push_back(i);
+      }
+    }
+  }
+
+  std::vector<std::pair<size_t, size_t>> calculate_q(size_t const from,
+                                                     size_t const to) {
+    std::vector<std::pair<size_t, size_t>> qset;  // inclusive intervals
+    constexpr size_t small_tau = tau / 4;
+    for (size_t i = from; i < to + tau; ++i) {
+      size_t first_min = i;
+      for (size_t j = i; j < i + small_tau; ++j) {
+        if (m_small_fps[j] < m_small_fps[first_min]) {
+          first_min = j;
+        }
+      }
+      size_t next_min = first_min + 1;
+      for (size_t j = next_min; j < first_min + small_tau; ++j) {
+        if (m_small_fps[j] < m_small_fps[next_min]) {
+          next_min = j;
+        }
+      }
+      if (m_small_fps[next_min] != m_small_fps[first_min]) {
+        i = next_min - 1;
+        continue;
+      }
+
+      size_t const period = next_min - first_min;
+      size_t run_start = first_min;
+      while (run_start > from &&
+             m_text[run_start - 1] == m_text[run_start + period - 1]) {
+        --run_start;
+      }
+      size_t run_end = next_min;  // inclusive
+      while (run_end < m_size - 1 &&
+             m_text[run_end + 1] == m_text[run_end - period + 1]) {
+        ++run_end;
+      }
+      if (run_end - run_start + 1 < tau) {
+        i = next_min - 1;
+        continue;
+      }
+      qset.emplace_back(run_start, run_end - tau + 1);
+      i = run_end - small_tau;
+
+      // Only the first slice that contains a long run stores its information.
+      if (run_end - run_start + 1 >= 3 * tau - 1 && run_start != 0 &&
+          m_text[run_start - 1] != m_text[run_start + period - 1]) {
+        size_t const sss_pos1 = run_start - 1;
+        size_t const sss_pos2 = run_end - (2 * tau) + 2;
+        int64_t const info = int64_t{1} * m_size - sss_pos2 + sss_pos1;
+        run_info[sss_pos1] =
+            m_text[run_end + 1] > m_text[run_end - period + 1] ? info : -info;
+      }
+    }
+    return qset;
+  }
+
+  uint8_t const* m_text;
+  size_t m_size;
+  std::vector<fp_type> m_fps;
+  std::vector<fp_type> m_fps3;
+  std::vector<fp_type> m_small_fps;
+};
+
+// The construction must give the same positions, fingerprints and run
+// information as the two-pass reference for any number of threads.
+template <uint64_t tau, typename rolling_hash_t = alx::rolling_hash::rk_prime<>>
+void test_reference_sss(std::vector<uint8_t> text) {
+  size_t const size = text.size();
+  text.resize(size + 4 * tau);
+  int const max_threads = omp_get_max_threads();
+  for (int threads : {1, 2, 3, 4}) {
+    omp_set_num_threads(threads);
+    alx::rolling_hash::sss<uint32_t, tau, rolling_hash_t> sss(text.data(), size,
+                                                              true);
+    reference_sss<tau, rolling_hash_t> reference(text.data(), size, threads);
+    EXPECT_EQ(sss.has_runs(), reference.has_runs) << threads;
+    EXPECT_EQ(sss.get_sss(), reference.sss) << threads;
+    EXPECT_TRUE(sss.get_fps() == reference.fps) << threads;
+    EXPECT_EQ(sss.num_runs(), reference.run_info.size()) << threads;
+    for (auto const& [pos, info] : reference.run_info) {
+      EXPECT_EQ(sss.get_run_info(pos), info) << threads << " " << pos;
+    }
+  }
+  omp_set_num_threads(max_threads);
+}
+
 template <typename char_t>
 size_t period(char_t* text_p, size_t n, size_t period_up_to) {
   return 0;
@@ -280,6 +573,21 @@ TEST(StringSynchronizingSet, NonRepetetive) {
                text.size() * 2 / (sss.tau + 1));
     EXPECT_TRUE(check_string_synchronizing_set(text, sss));
   }
+  {
+    alx::rolling_hash::sss<uint32_t, 16, alx::rolling_hash::rk_compact> sss(
+        text, true);
+    EXPECT_TRUE(check_string_synchronizing_set(text, sss));
+    alx::rolling_hash::sss<uint32_t, 16, alx::rolling_hash::rk_prime<61>>
+        sss_large_table(text, true);
+    EXPECT_EQ(sss.get_sss(), sss_large_table.get_sss());
+    // Compare the fingerprints of all 3tau-windows that end in the text.
+    for (size_t i = 0; i < sss.size() && sss[i] + 3 * sss.tau <= text.size();
+         ++i) {
+      EXPECT_EQ(sss.get_fps()[i], sss_large_table.get_fps()[i]);
+    }
+  }
+  test_compact_fps<16>(text);
+  test_sss_stream<16>(text);
 }
 
 TEST(StringSynchronizingSet, Repetetive) {
@@ -379,4 +687,60 @@ TEST(StringSynchronizingSet, Repetetive) {
     EXPECT_TRUE(sss.get_run_info(5) < sss.get_run_info(2059))
         << fmt::format("{} {}", sss.get_run_info(5), sss.get_run_info(2059));
   }
+  {
+    alx::rolling_hash::sss<uint32_t, 16, alx::rolling_hash::rk_compact> sss(
+        text, true);
+    EXPECT_TRUE(check_string_synchronizing_set(text, sss));
+    EXPECT_TRUE(sss.has_runs());
+    EXPECT_NE(sss.get_run_info(5), 0);
+    EXPECT_NE(sss.get_run_info(2059), 0);
+  }
+  test_compact_fps<4>(text);
+  test_compact_fps<16>(text);
+  test_sss_stream<4>(text);
+  test_sss_stream<16>(text);
+}
+
+TEST(StringSynchronizingSet, Reference) {
+  std::mt19937_64 gen(19);
+  std::uniform_int_distribution<size_t> char_dist(0, 3);
+  std::vector<uint8_t> random_text(20000);
+  for (auto& c : random_text) {
+    c = 'a' + char_dist(gen);
+  }
+  test_reference_sss<4>(random_text);
+  test_reference_sss<16>(random_text);
+  test_reference_sss<16, alx::rolling_hash::rk_compact>(random_text);
+
+  std::vector<uint8_t> const repetitive_text =
+      repetitive_text_and_queries<uint8_t>(20000).first;
+  test_reference_sss<4>(repetitive_text);
+  test_reference_sss<16>(repetitive_text);
+
+  // Random runs of periods up to 3 and lengths up to 400, which are separated
+  // by random gaps of up to 40 characters.
+  std::uniform_int_distribution<size_t> period_dist(1, 3);
+  std::uniform_int_distribution<size_t> run_dist(1, 400);
+  std::uniform_int_distribution<size_t> gap_dist(1, 40);
+  std::vector<uint8_t> run_text;
+  while (run_text.size() < 20000) {
+    size_t const period = period_dist(gen);
+    for (size_t k = 0; k < period; ++k) {
+      run_text.push_back('a' + char_dist(gen));
+    }
+    for (size_t k = run_dist(gen); k > 0; --k) {
+      run_text.push_back(run_text[run_text.size() - period]);
+    }
+    for (size_t k = gap_dist(gen); k > 0; --k) {
+      run_text.push_back('a' + char_dist(gen));
+    }
+  }
+  test_reference_sss<16>(run_text);
+  test_reference_sss<32>(run_text);
+
+  // Only the slices of the second half contain runs.
+  std::vector<uint8_t> half_run_text(random_text.begin(), random_text.end());
+  half_run_text.insert(half_run_text.end(), run_text.begin(), run_text.end());
+  test_reference_sss<16>(half_run_text);
+  test_reference_sss<32>(half_run_text);
 }
@@ -0,0 +1,209 @@
+/*******************************************************************************
+ * tests/suffix_sort/test_suffix_sort.cpp
+ *
+ * Copyright (C) 2026 Alexander Herlez <alexander.herlez@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <omp.h>
+
+#include <algorithm>
+#include <gsaca-double-sort/uint_types.hpp>  // uint40_t
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "lce/lce_fp.hpp"
+#include "lce/lce_naive.hpp"
+#include "lce/lce_sss.hpp"
+#include "suffix_sort/sparse_suffix_sort.hpp"
+#include "suffix_sort/suffix_array_construction.hpp"
+#include "test_texts.hpp"
+#include "util/blocked_scatter.hpp"
+
+template <typename lce_ds_type>
+void test_sparse_suffix_sort(size_t sample_rate) {
+  std::vector<uint8_t> text = repetitive_text_and_queries<uint8_t>(8000).first;
+  std::vector<uint8_t> const text_copy = text;
+  std::vector<uint32_t> positions;
+  for (size_t i = 0; i < text.size(); i += sample_rate) {
+    positions.push_back(i);
+  }
+  std::shuffle(positions.begin(), positions.end(), std::mt19937_64(42));
+
+  using naive = alx::lce::lce_naive<uint8_t>;
+  std::vector<uint32_t> expected = positions;
+  std::sort(expected.begin(), expected.end(), [&](size_t i, size_t j) {
+    return naive::is_leq_suffix(text_copy.data(), text_copy.size(), i, j);
+  });
+
+  lce_ds_type ds(text);
+  for (int threads : {1, 2, 4}) {
+    std::vector<uint32_t> ssa =
+        alx::suffix_sort::sparse_suffix_array(ds, positions, threads);
+    ASSERT_EQ(ssa, expected) << threads;
+
+    std::vector<uint32_t> lcp =
+        alx::suffix_sort::sparse_lcp_array(ds, ssa, threads);
+    ASSERT_EQ(lcp.size(), ssa.size());
+    EXPECT_EQ(lcp[0], 0u);
+    for (size_t k = 1; k < ssa.size(); ++k) {
+      ASSERT_EQ(lcp[k], naive::lce(text_copy.data(), text_copy.size(),
+                                   ssa[k - 1], ssa[k]))
+          << k;
+    }
+  }
+}
+
+TEST(SparseSuffixSort, All) {
+  std::vector<uint32_t> empty;
+  std::vector<uint8_t> text(8);
+  alx::lce::lce_naive<uint8_t> naive_ds(text);
+  EXPECT_TRUE(alx::suffix_sort::sparse_suffix_array(naive_ds, empty).empty());
+  EXPECT_TRUE(alx::suffix_sort::sparse_lcp_array(naive_ds, empty).empty());
+
+  test_sparse_suffix_sort<alx::lce::lce_naive<uint8_t>>(1);
+  test_sparse_suffix_sort<alx::lce::lce_fp<uint8_t>>(3);
+  test_sparse_suffix_sort<alx::lce::lce_fp<uint8_t, 64, false>>(1);
+  test_sparse_suffix_sort<alx::lce::lce_sss<uint8_t, 16>>(5);
+}
+
+template <typename t_backend, typename t_index_type, typename t_char_type>
+void test_construction(std::vector<t_char_type> const& text) {
+  using naive = alx::lce::lce_naive<t_char_type>;
+  std::vector<uint64_t> expected(text.size());
+  std::iota(expected.begin(), expected.end(), 0);
+  std::sort(expected.begin(), expected.end(), [&](size_t i, size_t j) {
+    return i != j && naive::is_leq_suffix(text.data(), text.size(), i, j);
+  });
+
+  std::vector<t_index_type> sa =
+      alx::suffix_sort::suffix_array<t_index_type, t_backend>(text.data(),
+                                                              text.size());
+  ASSERT_EQ(sa.size(), text.size());
+  for (size_t k = 0; k < sa.size(); ++k) {
+    ASSERT_EQ(static_cast<uint64_t>(sa[k]), expected[k]) << k;
+  }
+  if (text.empty()) {
+    return;
+  }
+
+  std::vector<t_index_type> isa = alx::suffix_sort::inverse_suffix_array(sa);
+  for (size_t k = 0; k < sa.size(); ++k) {
+    ASSERT_EQ(static_cast<uint64_t>(isa[sa[k]]), k);
+  }
+
+  std::vector<t_index_type> lcp =
+      alx::suffix_sort::lcp_array<t_backend>(text.data(), text.size(), sa, isa);
+  std::vector<t_index_type> plcp =
+      alx::suffix_sort::plcp_array<t_backend>(text.data(), text.size(), sa);
+  EXPECT_EQ(static_cast<uint64_t>(lcp[0]), 0u);
+  for (size_t k = 1; k < sa.size(); ++k) {
+    size_t const expected_lcp =
+        naive::lce(text.data(), text.size(), sa[k - 1], sa[k]);
+    ASSERT_EQ(static_cast<uint64_t>(lcp[k]), expected_lcp) << k;
+    ASSERT_EQ(static_cast<uint64_t>(plcp[sa[k]]), expected_lcp) << k;
+  }
+  EXPECT_EQ(static_cast<uint64_t>(plcp[sa[0]]), 0u);
+}
+
+template <typename t_backend>
+void test_construction_backend() {
+  std::vector<uint8_t> const text =
+      repetitive_text_and_queries<uint8_t>(8000).first;
+  test_construction<t_backend, uint32_t>(std::vector<uint8_t>());
+  test_construction<t_backend, uint32_t>(std::vector<uint8_t>{'a'});
+  test_construction<t_backend, uint32_t>(std::vector<uint8_t>(1000, 'a'));
+  test_construction<t_backend, uint32_t>(text);
+  test_construction<t_backend, uint64_t>(text);
+  test_construction<t_backend, gsaca_lyndon::uint40_t>(text);
+
+  // Integer alphabets, e.g., reduced fingerprints.
+  std::mt19937_64 gen(42);
+  std::vector<uint32_t> fps(5000);
+  for (auto& c : fps) {
+    c = 1 + gen() % 100;
+  }
+  std::fill(fps.begin() + 1000, fps.begin() + 1200, 7);
+  test_construction<t_backend, uint32_t>(fps);
+  test_construction<t_backend, gsaca_lyndon::uint40_t>(fps);
+
+  std::vector<uint64_t> large_fps(3000);
+  for (auto& c : large_fps) {
+    c = (gen() % 4) << 60;
+  }
+  test_construction<t_backend, uint64_t>(large_fps);
+
+  std::vector<int32_t> signed_text(3000);
+  for (auto& c : signed_text) {
+    c = static_cast<int32_t>(gen() % 5) - 2;
+  }
+  test_construction<t_backend, uint32_t>(signed_text);
+}
+
+TEST(SuffixArrayConstruction, Gsaca) {
+  test_construction_backend<alx::suffix_sort::gsaca_backend>();
+}
+
+TEST(SuffixArrayConstruction, Libsais) {
+  test_construction_backend<alx::suffix_sort::libsais_backend>();
+}
+
+TEST(SuffixArrayConstruction, PhiLcp) {
+  using alx::suffix_sort::gsaca_backend;
+  using alx::suffix_sort::libsais_backend;
+  using alx::suffix_sort::with_phi_lcp;
+  test_construction_backend<with_phi_lcp<gsaca_backend>>();
+  test_construction_backend<with_phi_lcp<libsais_backend>>();
+
+  // Large enough for the blocked scatter.
+  std::vector<uint8_t> const text =
+      repetitive_text_and_queries<uint8_t>(400000).first;
+  test_construction<with_phi_lcp<gsaca_backend>, uint32_t>(text);
+  test_construction<with_phi_lcp<libsais_backend>, gsaca_lyndon::uint40_t>(
+      text);
+}
+
+// An index type of three bytes, so that pairs of it do not divide cache lines.
+struct uint24_t {
+  uint8_t bytes[3];
+  uint24_t(uint64_t x = 0)
+      : bytes{uint8_t(x), uint8_t(x >> 8), uint8_t(x >> 16)} {
+  }
+  operator uint64_t() const {
+    return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16);
+  }
+};
+
+template <typename t_index_type, size_t t_block_bytes, size_t t_num_rounds,
+          size_t t_max_fanout_bits = 11>
+void test_blocked_scatter(size_t size) {
+  std::vector<uint64_t> perm(size);
+  std::iota(perm.begin(), perm.end(), 0);
+  std::shuffle(perm.begin(), perm.end(), std::mt19937_64(size));
+
+  std::vector<t_index_type> out(size + 3, t_index_type{7});
+  alx::util::blocked_scatter<t_block_bytes, t_num_rounds, t_max_fanout_bits>(
+      size, out.data(), out.size(), [&perm](size_t k) { return perm[k]; },
+      [](size_t k) { return (7 * k) % 65521; });
+  for (size_t k = 0; k < size; ++k) {
+    ASSERT_EQ(static_cast<uint64_t>(out[perm[k]]), (7 * k) % 65521) << k;
+  }
+  for (size_t k = size; k < out.size(); ++k) {
+    ASSERT_EQ(static_cast<uint64_t>(out[k]), 7u) << k;
+  }
+}
+
+TEST(SuffixArrayConstruction, BlockedScatter) {
+  test_blocked_scatter<uint32_t, 1 << 18, 4>(0);
+  test_blocked_scatter<uint32_t, 1 << 18, 4>(1000);
+  test_blocked_scatter<uint32_t, 1 << 18, 4>(1 << 20);
+  test_blocked_scatter<uint32_t, 1 << 12, 1>(100000);
+  test_blocked_scatter<uint32_t, 1 << 10, 3, 4>(100003);
+  test_blocked_scatter<uint64_t, 1 << 12, 3>(300001);
+  test_blocked_scatter<uint16_t, 1 << 10, 2>(65000);
+  test_blocked_scatter<gsaca_lyndon::uint40_t, 1 << 14, 4>(200000);
+  test_blocked_scatter<uint24_t, 1 << 14, 4>(200000);
+}
@@ -0,0 +1,49 @@
+/*******************************************************************************
+ * tests/test_texts.hpp
+ *
+ * Copyright (C) 2026 Alexander Herlez <alexander.herlez@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Return a text with long repeats and a run, together with queries that hit
+// short and long common extensions.
+template <typename char_type>
+std::pair<std::vector<char_type>, std::vector<std::pair<size_t, size_t>>>
+repetitive_text_and_queries(size_t size) {
+  std::mt19937_64 gen(size);
+  std::uniform_int_distribution<size_t> char_dist(0, 3);
+  std::uniform_int_distribution<size_t> pos_dist(0, size - 1);
+
+  std::vector<char_type> text(size);
+  for (auto& c : text) {
+    c = 'a' + char_dist(gen);
+  }
+  std::vector<std::pair<size_t, size_t>> queries;
+  for (size_t k = 0; k < 20; ++k) {
+    size_t const from = pos_dist(gen);
+    size_t const to = pos_dist(gen);
+    size_t const len = std::min({size - from, size - to, size_t{1000}});
+    std::vector<char_type> copy(text.begin() + from,
+                                text.begin() + from + len);
+    std::copy(copy.begin(), copy.end(), text.begin() + to);
+    queries.emplace_back(from, to);
+  }
+  for (size_t i = size / 2; i < std::min(size, size / 2 + 600); ++i) {
+    text[i] = 'a' + (i % 3);
+  }
+  for (size_t k = 0; k < 20; ++k) {
+    queries.emplace_back(size / 2 + k, size / 2 + 3 * k + 3);
+  }
+  for (size_t k = 0; k < 1000; ++k) {
+    queries.emplace_back(pos_dist(gen), pos_dist(gen));
+  }
+  return {text, queries};
+}